@@ -21,6 +21,7 @@
 #include "../../lib/vcl/vectormath_exp.h"
 
 #include <algorithm>
+#include <limits>
 #include <numeric>
 #include <random>
 
@@ -166,11 +167,12 @@ void DSPCORE_NAME::setup(double sampleRate)
     units[idx].gainEnvelope.setup(
       sampleRate, param.value[ParameterID::gainS]->getFloat());
   }
+  ghostUnit.gainEnvelope.setup(sampleRate, param.value[ParameterID::gainS]->getFloat());
 
   for (auto &note : notes) note.setup(sampleRate);
 
-  // 2 msec + 1 sample transition time.
-  transitionBuffer.resize(1 + size_t(sampleRate * 0.01), {0.0f, 0.0f});
+  // 10 msec + 1 sample fade out time for stolen voices.
+  ghostFadeSamples = 1 + int(sampleRate * 0.01);
 
   startup();
   prepareRefresh = true;
@@ -185,10 +187,44 @@ void PROCESSING_UNIT_NAME::reset()
   gainEnvelope.terminate();
 }
 
+void PROCESSING_UNIT_NAME::copyLane(
+  int index, const PROCESSING_UNIT_NAME &src, int srcIndex)
+{
+  osc.copyLane(index, src.osc, srcIndex);
+  lfo.copyLane(index, src.lfo, srcIndex);
+  lfoSmoother.copyLane(index, src.lfoSmoother, srcIndex);
+  gainEnvelope.copyLane(index, src.gainEnvelope, srcIndex);
+  pitchEnvelope.copyLane(index, src.pitchEnvelope, srcIndex);
+  lowpassEnvelope.copyLane(index, src.lowpassEnvelope, srcIndex);
+
+  notePitch.insert(index, src.notePitch[srcIndex]);
+  pitch.insert(index, src.pitch[srcIndex]);
+  lowpassPitch.insert(index, src.lowpassPitch[srcIndex]);
+  notePan.insert(index, src.notePan[srcIndex]);
+  frequency.insert(index, src.frequency[srcIndex]);
+  gain.insert(index, src.gain[srcIndex]);
+  gain0.insert(index, src.gain0[srcIndex]);
+  gain1.insert(index, src.gain1[srcIndex]);
+  velocity.insert(index, src.velocity[srcIndex]);
+}
+
+void PROCESSING_UNIT_NAME::clearLane(int index)
+{
+  gainEnvelope.terminate(index);
+  pitchEnvelope.terminate(index);
+  lowpassEnvelope.terminate(index);
+  gain.insert(index, 0);
+  gain0.insert(index, 0);
+  gain1.insert(index, 0);
+  velocity.insert(index, 0);
+}
+
 void DSPCORE_NAME::reset()
 {
   for (auto &note : notes) note.rest();
   for (auto &unit : units) unit.reset();
+  ghostUnit.reset();
+  ghostUnit.velocity = 0;
   info.reset();
   startup();
 }
@@ -256,6 +292,7 @@ void DSPCORE_NAME::setParameters(float tempo)
   info.lfoLowpass.push(param.value[ID::lfoLowpass]->getFloat());
 
   for (auto &unit : units) unit.setParameters(sampleRate, info, param);
+  ghostUnit.setParameters(sampleRate, info, param);
 
   nVoice = 16 * (param.value[ID::nVoice]->getInt() + 1);
   if (nVoice > notes.size()) nVoice = notes.size();
@@ -273,7 +310,7 @@ void DSPCORE_NAME::setParameters(float tempo)
 
 std::array<float, 2> PROCESSING_UNIT_NAME::process(
   float sampleRate,
-  Wavetable<tableSize, nOvertone> &wavetable,
+  const WavetableType &wavetable,
   LfoWavetable<lfoTableSize> &lfoWavetable,
   NoteProcessInfo &info)
 {
@@ -296,7 +333,7 @@ std::array<float, 2> PROCESSING_UNIT_NAME::process(
   lowpassPitch = (lpPt + lpKey * (lpCutoff * (float(nTable) - pitch) - lpPt))
     - lowpassEnvelope.process() * info.tableLowpassEnvelopeAmount.getValue();
   lowpassPitch = select(lowpassPitch < 0.0f, 0.0f, lowpassPitch);
-  Vec16f sig = osc.processCubic(lowpassPitch + pitch, wavetable.table);
+  Vec16f sig = osc.processCubic(lowpassPitch + pitch, wavetable);
 
   gain = velocity * gainEnvelope.process();
   isActive = horizontal_add(gain) != 0;
@@ -312,53 +349,61 @@ std::array<float, 2> PROCESSING_UNIT_NAME::process(
 
 void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 {
-  if (wavetable.isRefreshing) {
+  // Table is swapped only here, so voices keep playing previous table while the worker
+  // builds next one.
+  wavetable = tableWorker.acquire();
+  if (wavetable == nullptr) {
     for (int i = 0; i < length; ++i) {
-      processMidiNote(i);
       out0[i] = 0;
       out1[i] = 0;
     }
+    processMidiNote(midiNotes.endOfBlock);
     return;
   }
 
   SmootherCommon<float>::setBufferSize(length);
 
   std::array<float, 2> frame{};
-  for (uint32_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    info.masterPitch.process();
-    info.equalTemperament.process();
-    info.pitchA4Hz.process();
-    info.tableLowpass.process();
-    info.tableLowpassKeyFollow.process();
-    info.tableLowpassEnvelopeAmount.process();
-    info.pitchEnvelopeAmount.process();
-    info.lfoFrequency.process();
-    info.lfoPitchAmount.process();
-    info.lfoLowpass.process();
-
-    frame.fill(0.0f);
-
-    for (auto &unit : units) {
-      if (!unit.isActive) continue;
-      auto sig = unit.process(sampleRate, wavetable, lfoWavetable, info);
-      frame[0] += sig[0];
-      frame[1] += sig[1];
-    }
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      info.masterPitch.process();
+      info.equalTemperament.process();
+      info.pitchA4Hz.process();
+      info.tableLowpass.process();
+      info.tableLowpassKeyFollow.process();
+      info.tableLowpassEnvelopeAmount.process();
+      info.pitchEnvelopeAmount.process();
+      info.lfoFrequency.process();
+      info.lfoPitchAmount.process();
+      info.lfoLowpass.process();
+
+      frame.fill(0.0f);
+
+      for (auto &unit : units) {
+        if (!unit.isActive) continue;
+        auto sig = unit.process(sampleRate, *wavetable, lfoWavetable, info);
+        frame[0] += sig[0];
+        frame[1] += sig[1];
+      }
 
-    if (isTransitioning) {
-      frame[0] += transitionBuffer[trIndex][0];
-      frame[1] += transitionBuffer[trIndex][1];
-      transitionBuffer[trIndex].fill(0.0f);
-      trIndex = (trIndex + 1) % transitionBuffer.size();
-      if (trIndex == trStop) isTransitioning = false;
-    }
+      if (ghostUnit.isActive) {
+        ghostUnit.velocity -= ghostFadeDelta;
+        ghostUnit.velocity = select(ghostUnit.velocity < 0.0f, 0.0f, ghostUnit.velocity);
+        auto sig = ghostUnit.process(sampleRate, *wavetable, lfoWavetable, info);
+        frame[0] += sig[0];
+        frame[1] += sig[1];
+      }
 
-    const auto masterGain = interpMasterGain.process();
-    out0[i] = masterGain * frame[0];
-    out1[i] = masterGain * frame[1];
+      const auto masterGain = interpMasterGain.process();
+      out0[i] = masterGain * frame[0];
+      out1[i] = masterGain * frame[1];
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
+
+  compactVoices();
 }
 
 enum UnisonPanType {
@@ -395,6 +440,47 @@ void DSPCORE_NAME::terminateNotes(size_t nNote)
   }
 }
 
+/**
+Keeps sounding notes on the lowest lanes, so that `process` only runs the units up to the
+highest sounding note. Called once per block.
+
+Notes are set to rest when their gain envelope is terminated. Then the highest sounding
+note is moved to the lowest resting lane, as long as it makes a unit empty. Moving only
+copies the lane state, so the sound doesn't change.
+*/
+void DSPCORE_NAME::compactVoices()
+{
+  for (auto &note : notes) {
+    if (note.state == NoteState::rest) continue;
+    auto &unit = units[note.arrayIndex];
+    if (!unit.isActive || unit.gainEnvelope.isTerminated(note.vecIndex)) note.rest();
+  }
+
+  size_t lo = 0;
+  size_t hi = notes.size();
+  while (true) {
+    while (lo < notes.size() && notes[lo].state != NoteState::rest) ++lo;
+    while (hi > 0 && notes[hi - 1].state == NoteState::rest) --hi;
+    if (hi == 0 || lo / 16 >= (hi - 1) / 16) break;
+
+    auto &src = notes[hi - 1];
+    auto &dst = notes[lo];
+    auto &dstUnit = units[dst.arrayIndex];
+    dstUnit.copyLane(dst.vecIndex, units[src.arrayIndex], src.vecIndex);
+    dstUnit.isActive = true;
+    units[src.arrayIndex].clearLane(src.vecIndex);
+
+    dst.state = src.state;
+    dst.id = src.id;
+    src.rest();
+    src.id = -1;
+  }
+
+  // Units above the highest sounding note are empty.
+  for (size_t idx = (hi + 15) / 16; idx < units.size(); ++idx)
+    units[idx].isActive = false;
+}
+
 void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float velocity)
 {
   using ID = ParameterID::ID;
@@ -414,7 +500,7 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
   if (noteIndices.size() < nUnison) {
     sortVoiceIndicesByGain();
     for (auto &index : voiceIndices) {
-      fillTransitionBuffer(index);
+      fadeOutVoice(index);
       noteIndices.push_back(index);
       if (noteIndices.size() >= nUnison) break;
     }
@@ -539,37 +625,30 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
   terminateNotes(nUnison);
 }
 
-void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
+/**
+Moves a stolen voice to `ghostUnit`. The ghost lane keeps running, and its velocity
+linearly decreases to 0 in `ghostFadeSamples`. If all ghost lanes are used, the one
+closest to the end of fade is overwritten.
+*/
+void DSPCORE_NAME::fadeOutVoice(size_t noteIndex)
 {
-  isTransitioning = true;
-
-  // Beware the negative overflow. trStop is size_t.
-  trStop = trIndex - 1;
-  if (trStop >= transitionBuffer.size()) trStop += transitionBuffer.size();
-
   auto &unit = units[notes[noteIndex].arrayIndex];
   auto vecIndex = notes[noteIndex].vecIndex;
-
-  float gain0 = unit.gain0[vecIndex];
-  float gain1 = unit.gain1[vecIndex];
-  float pitch = unit.lowpassPitch[vecIndex] + unit.pitch[vecIndex];
-  trOsc.phase = unit.osc.phase.extract(vecIndex);
-  trOsc.tick = unit.osc.tick.extract(vecIndex);
-
-  for (size_t bufIdx = 0; bufIdx < transitionBuffer.size(); ++bufIdx) {
-    if (notes[noteIndex].state == NoteState::rest) {
-      trStop = trIndex + bufIdx;
-      if (trStop >= transitionBuffer.size()) trStop -= transitionBuffer.size();
-      break;
-    }
-
-    float oscOut = trOsc.process(pitch, wavetable.table);
-    auto idx = (trIndex + bufIdx) % transitionBuffer.size();
-    auto interp = 1.0f - float(bufIdx) / transitionBuffer.size();
-
-    transitionBuffer[idx][0] += oscOut * interp * gain0;
-    transitionBuffer[idx][1] += oscOut * interp * gain1;
+  if (!unit.isActive || unit.gain[vecIndex] == 0) return;
+
+  int ghostIndex = 0;
+  float minRemaining = std::numeric_limits<float>::max();
+  for (int idx = 0; idx < 16; ++idx) {
+    float velocity = ghostUnit.velocity[idx];
+    float remaining = velocity <= 0 ? 0 : velocity / ghostFadeDelta[idx];
+    if (remaining >= minRemaining) continue;
+    minRemaining = remaining;
+    ghostIndex = idx;
   }
+
+  ghostUnit.copyLane(ghostIndex, unit, vecIndex);
+  ghostUnit.isActive = true;
+  ghostFadeDelta.insert(ghostIndex, unit.velocity[vecIndex] / ghostFadeSamples);
 }
 
 void DSPCORE_NAME::noteOff(int32_t noteId)
@@ -582,33 +661,38 @@ void DSPCORE_NAME::refreshTable()
 {
   using ID = ParameterID::ID;
 
-  reset();
-
   const float tableBaseFreq = param.value[ID::tableBaseFrequency]->getFloat();
   const float pitchMultiplier = param.value[ID::overtonePitchMultiply]->getFloat();
   const float pitchModulo = param.value[ID::overtonePitchModulo]->getFloat();
   const float gainPow = param.value[ID::overtoneGainPower]->getFloat();
   const float widthMul = param.value[ID::overtoneWidthMultiply]->getFloat();
 
+  PadSynthConfig<nOvertone> cfg;
   for (size_t idx = 0; idx < nOvertone; ++idx) {
-    otFrequency[idx] = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
+    cfg.frequency[idx] = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
       * param.value[ID::overtonePitch0 + idx]->getFloat();
     if (pitchModulo != 0)
-      otFrequency[idx]
-        = fmodf(otFrequency[idx], notePitchToFrequency(pitchModulo, 12.0f, 440.0f));
-    otGain[idx] = powf(param.value[ID::overtoneGain0 + idx]->getFloat(), gainPow);
-    otBandWidth[idx] = widthMul * param.value[ID::overtoneWidth0 + idx]->getFloat();
-    otPhase[idx] = param.value[ID::overtonePhase0 + idx]->getFloat();
+      cfg.frequency[idx]
+        = fmodf(cfg.frequency[idx], notePitchToFrequency(pitchModulo, 12.0f, 440.0f));
+    cfg.gain[idx] = powf(param.value[ID::overtoneGain0 + idx]->getFloat(), gainPow);
+    cfg.bandWidth[idx] = widthMul * param.value[ID::overtoneWidth0 + idx]->getFloat();
+    cfg.phase[idx] = param.value[ID::overtonePhase0 + idx]->getFloat();
   }
 
-  wavetable.padsynth(
-    sampleRate, tableBaseFreq, otFrequency, otGain, otPhase, otBandWidth,
-    param.value[ID::padSynthSeed]->getInt(), param.value[ID::spectrumExpand]->getFloat(),
-    int32_t(param.value[ID::spectrumShift]->getInt()) - spectrumSize,
-    param.value[ID::profileComb]->getInt() + 1, param.value[ID::profileShape]->getFloat(),
-    param.value[ID::overtonePitchRandom]->getInt(),
-    param.value[ID::spectrumInvert]->getInt(),
-    param.value[ID::uniformPhaseProfile]->getInt());
+  cfg.sampleRate = sampleRate;
+  cfg.tableBaseFreq = tableBaseFreq;
+  cfg.seed = param.value[ID::padSynthSeed]->getInt();
+  cfg.expand = param.value[ID::spectrumExpand]->getFloat();
+  cfg.shift = int32_t(param.value[ID::spectrumShift]->getInt()) - spectrumSize;
+  cfg.profileSkip = param.value[ID::profileComb]->getInt() + 1;
+  cfg.profileShape = param.value[ID::profileShape]->getFloat();
+  cfg.randomPitch = param.value[ID::overtonePitchRandom]->getInt();
+  cfg.invertSpectrum = param.value[ID::spectrumInvert]->getInt();
+  cfg.uniformPhaseProfile = param.value[ID::uniformPhaseProfile]->getInt();
+  cfg.mipmap = param.value[ID::tableMipmap]->getInt();
+
+  // Notes aren't reset. They keep playing current table until the worker finishes.
+  tableWorker.request(cfg);
 }
 
 void DSPCORE_NAME::refreshLfo()
@@ -18,7 +18,9 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/dsp/tableworker.hpp"
 #include "../parameter.hpp"
 #include "envelope.hpp"
 #include "noise.hpp"
@@ -38,6 +40,9 @@ constexpr size_t nUnit = 8;
 
 enum class NoteState { active, release, rest };
 
+using WavetableType = Wavetable<tableSize, nOvertone>;
+using WavetableCache = SharedTableCache<WavetableType, PadSynthConfig<nOvertone>>;
+
 struct NoteProcessInfo {
   std::minstd_rand rng{0};
 
@@ -91,10 +96,12 @@ struct NoteProcessInfo {
     void setParameters(float sampleRate, NoteProcessInfo &info, GlobalParameter &param); \
     std::array<float, 2> process(                                                        \
       float sampleRate,                                                                  \
-      Wavetable<tableSize, nOvertone> &wavetable,                                        \
+      const WavetableType &wavetable,                                                    \
       LfoWavetable<lfoTableSize> &lfoWavetable,                                          \
       NoteProcessInfo &info);                                                            \
     void reset();                                                                        \
+    void copyLane(int index, const ProcessingUnit_##INSTRSET &src, int srcIndex);        \
+    void clearLane(int index);                                                           \
   };
 
 PROCESSING_UNIT_CLASS(AVX512)
@@ -151,6 +158,7 @@ public:
   virtual void noteOff(int32_t noteId) = 0;
   virtual void refreshTable() = 0;
   virtual void refreshLfo() = 0;
+  virtual bool isTableReady() = 0; // True after the first table is built.
 
   struct MidiNote {
     bool isNoteOn;
@@ -161,7 +169,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   virtual void pushMidiNote(
     bool isNoteOn,
@@ -185,10 +193,10 @@ public:
     void setParameters(float tempo) override;                                            \
     void process(const size_t length, float *out0, float *out1) override;                \
     void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) override;   \
-    void fillTransitionBuffer(size_t noteIndex);                                         \
     void noteOff(int32_t noteId) override;                                               \
     void refreshTable() override;                                                        \
     void refreshLfo() override;                                                          \
+    bool isTableReady() override { return tableWorker.isReady(); }                       \
                                                                                          \
     void pushMidiNote(                                                                   \
       bool isNoteOn,                                                                     \
@@ -205,40 +213,39 @@ public:
       note.pitch = pitch;                                                                \
       note.tuning = tuning;                                                              \
       note.velocity = velocity;                                                          \
-      midiNotes.push_back(note);                                                         \
+      midiNotes.push(note);                                                              \
     }                                                                                    \
                                                                                          \
     void processMidiNote(uint32_t frame) override                                        \
     {                                                                                    \
-      while (true) {                                                                     \
-        auto it                                                                          \
-          = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {   \
-              return nt.frame == frame;                                                  \
-            });                                                                          \
-        if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
-          noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
+      midiNotes.dispatch(frame, [&](const MidiNote &nt) {                                \
+        if (nt.isNoteOn)                                                                 \
+          noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);                               \
         else                                                                             \
-          noteOff(it->id);                                                               \
-        midiNotes.erase(it);                                                             \
-      }                                                                                  \
+          noteOff(nt.id);                                                                \
+      });                                                                                \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
     void sortVoiceIndicesByGain();                                                       \
     void terminateNotes(size_t nNote);                                                   \
+    void compactVoices();                                                                \
+    void fadeOutVoice(size_t noteIndex);                                                 \
                                                                                          \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
-    std::array<float, nOvertone> otFrequency{};                                          \
-    std::array<float, nOvertone> otGain{};                                               \
-    std::array<float, nOvertone> otPhase{};                                              \
-    std::array<float, nOvertone> otBandWidth{};                                          \
     bool prepareRefresh = true;                                                          \
     bool isTableRefeshed = false;                                                        \
     bool isLFORefreshed = false;                                                         \
                                                                                          \
-    Wavetable<tableSize, nOvertone> wavetable;                                           \
+    TableWorker<WavetableType, PadSynthConfig<nOvertone>> tableWorker{                   \
+      [](const PadSynthConfig<nOvertone> &config) {                                      \
+        return WavetableCache::instance().acquire(                                       \
+          config, [](WavetableType &table, const PadSynthConfig<nOvertone> &config) {    \
+            table.padsynthWithCache(config);                                             \
+          });                                                                            \
+      }};                                                                                \
+    const WavetableType *wavetable = nullptr; /* Front table. Updated for each block. */ \
     LfoWavetable<lfoTableSize> lfoWavetable;                                             \
     std::array<ProcessingUnit_##INSTRSET, nUnit> units;                                  \
                                                                                          \
@@ -252,11 +259,10 @@ public:
     NoteProcessInfo info;                                                                \
     LinearSmoother<float> interpMasterGain;                                              \
                                                                                          \
-    std::vector<std::array<float, 2>> transitionBuffer{};                                \
-    bool isTransitioning = false;                                                        \
-    size_t trIndex = 0;                                                                  \
-    size_t trStop = 0;                                                                   \
-    TableOsc<tableSize> trOsc;                                                           \
+    /* Stolen voices are moved to ghost lanes, and fade out in `process`. */             \
+    ProcessingUnit_##INSTRSET ghostUnit;                                                 \
+    Vec16f ghostFadeDelta = 0;                                                           \
+    float ghostFadeSamples = 1;                                                          \
   };
 
 DSPCORE_CLASS(AVX512)
@@ -96,9 +96,29 @@ public:
     state = stateTerminated;
   }
 
+  void terminate(int index)
+  {
+    value.insert(index, 0);
+    out.insert(index, 0);
+    state.insert(index, stateTerminated);
+  }
+
+  // Moves state of a lane of `src` to `index`. Used to compact active voices.
+  void copyLane(int index, const ExpADSREnvelope16 &src, int srcIndex)
+  {
+    declickInRamp.insert(index, src.declickInRamp[srcIndex]);
+    declickIn.insert(index, src.declickIn[srcIndex]);
+    atk.insert(index, src.atk[srcIndex]);
+    dec.insert(index, src.dec[srcIndex]);
+    rel.insert(index, src.rel[srcIndex]);
+    state.insert(index, src.state[srcIndex]);
+    value.insert(index, src.value[srcIndex]);
+    out.insert(index, src.out[srcIndex]);
+  }
+
   bool isAttacking(int index) { return state[index] == stateAttack; }
   bool isReleasing(int index) { return state[index] == stateRelease; }
-  bool isTerminated(int index) { return state[index] == stateTerminated; }
+  bool isTerminated(int index) { return state[index] >= stateTerminated; }
   float extract(int index) { return out[index]; }
 
   Vec16f process()
@@ -207,9 +227,26 @@ public:
     state.insert(index, stateRelease);
   }
 
+  void terminate(int index)
+  {
+    value.insert(index, 0);
+    out.insert(index, 0);
+    state.insert(index, stateTerminated);
+  }
+
+  void copyLane(int index, const LinearADSREnvelope16 &src, int srcIndex)
+  {
+    atk.insert(index, src.atk[srcIndex]);
+    dec.insert(index, src.dec[srcIndex]);
+    rel.insert(index, src.rel[srcIndex]);
+    state.insert(index, src.state[srcIndex]);
+    value.insert(index, src.value[srcIndex]);
+    out.insert(index, src.out[srcIndex]);
+  }
+
   bool isAttacking(int index) { return state[index] == stateAttack; }
   bool isReleasing(int index) { return state[index] == stateRelease; }
-  bool isTerminated(int index) { return state[index] == stateTerminated; }
+  bool isTerminated(int index) { return state[index] >= stateTerminated; }
 
   Vec16f process()
   {
@@ -22,13 +22,20 @@
 #include "../../lib/vcl/vectorclass.h"
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/parallelfor.hpp"
 #include "../../common/dsp/somemath.hpp"
+#include "../../common/dsp/tablecache.hpp"
+#include "../../common/dsp/tablediskcache.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cstring>
 #include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <vector>
 
 namespace SomeDSP {
 
@@ -58,6 +65,94 @@ inline Vec16f cubicInterp(Vec16f y0, Vec16f y1, Vec16f y2, Vec16f y3, Vec16f t)
   return c3 * t * t2 - (c2 + c3) * t2 + c1 * t + y1;
 }
 
+// FFTW planner isn't thread safe. Plans are created on table worker threads of every
+// plugin instance, so they must be serialized.
+inline std::mutex &fftwPlannerMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Bump this when the content or the layout of Wavetable changes.
+constexpr uint32_t wavetableCacheVersion = 1;
+
+inline TableDiskCache &wavetableDiskCache()
+{
+  static TableDiskCache cache("CubicPadSynth", wavetableCacheVersion);
+  return cache;
+}
+
+// Set of parameters which changes the content of Wavetable.
+template<size_t nPeak> struct PadSynthConfig {
+  float sampleRate = 44100.0f;
+  float tableBaseFreq = 20.0f;
+  std::array<float, nPeak> frequency{};
+  std::array<float, nPeak> gain{};
+  std::array<float, nPeak> phase{};
+  std::array<float, nPeak> bandWidth{};
+  uint32_t seed = 0;
+  float expand = 1.0f;
+  int32_t shift = 0;
+  uint32_t profileSkip = 1;
+  uint32_t profileShape = 1;
+  bool randomPitch = false;
+  bool invertSpectrum = false;
+  bool uniformPhaseProfile = false;
+  bool mipmap = false;
+
+  uint64_t hash() const
+  {
+    uint64_t h = fnv1a(sampleRate, 0xcbf29ce484222325);
+    h = fnv1a(tableBaseFreq, h);
+    h = fnv1a(frequency.data(), sizeof(float) * nPeak, h);
+    h = fnv1a(gain.data(), sizeof(float) * nPeak, h);
+    h = fnv1a(phase.data(), sizeof(float) * nPeak, h);
+    h = fnv1a(bandWidth.data(), sizeof(float) * nPeak, h);
+    h = fnv1a(seed, h);
+    h = fnv1a(expand, h);
+    h = fnv1a(shift, h);
+    h = fnv1a(profileSkip, h);
+    h = fnv1a(profileShape, h);
+    h = fnv1a(randomPitch, h);
+    h = fnv1a(invertSpectrum, h);
+    h = fnv1a(uniformPhaseProfile, h);
+    return fnv1a(mipmap, h);
+  }
+
+  // Stored in TableDiskCache, and compared byte by byte on load.
+  std::vector<uint8_t> serialize() const
+  {
+    std::vector<uint8_t> bytes;
+    appendBytes(bytes, sampleRate);
+    appendBytes(bytes, tableBaseFreq);
+    appendBytes(bytes, frequency);
+    appendBytes(bytes, gain);
+    appendBytes(bytes, phase);
+    appendBytes(bytes, bandWidth);
+    appendBytes(bytes, seed);
+    appendBytes(bytes, expand);
+    appendBytes(bytes, shift);
+    appendBytes(bytes, profileSkip);
+    appendBytes(bytes, profileShape);
+    appendBytes(bytes, randomPitch);
+    appendBytes(bytes, invertSpectrum);
+    appendBytes(bytes, uniformPhaseProfile);
+    appendBytes(bytes, mipmap);
+    return bytes;
+  }
+
+  bool operator==(const PadSynthConfig &rhs) const
+  {
+    return sampleRate == rhs.sampleRate && tableBaseFreq == rhs.tableBaseFreq
+      && frequency == rhs.frequency && gain == rhs.gain && phase == rhs.phase
+      && bandWidth == rhs.bandWidth && seed == rhs.seed && expand == rhs.expand
+      && shift == rhs.shift && profileSkip == rhs.profileSkip
+      && profileShape == rhs.profileShape && randomPitch == rhs.randomPitch
+      && invertSpectrum == rhs.invertSpectrum
+      && uniformPhaseProfile == rhs.uniformPhaseProfile && mipmap == rhs.mipmap;
+  }
+};
+
 /*
 table is 2d array which has extra padding for interpolation.
 
@@ -76,49 +171,48 @@ table is 2d array which has extra padding for interpolation.
 - Padded last column has first element of original table.
 - Padded first row is copy of first row of original table.
 - Padded last 3 row is silence.
+
+When mipmap is enabled, length of each row is shrinked to the power of 2 which is enough
+to hold its band limited spectrum. Padding is the same as above for each row. Oscillators
+scale phase by `phaseScale[row]` to read shorter rows.
 */
-template<size_t tableSize, size_t nPeak> struct Wavetable {
+template<size_t tableSize, size_t nPeak>
+struct Wavetable : std::enable_shared_from_this<Wavetable<tableSize, nPeak>> {
   static constexpr size_t spectrumSize = tableSize / 2 + 1;
   static constexpr size_t paddedSize = tableSize + 3;
+
+  // Mipmapped row holds at least `mipmapOversample` times more samples than the band
+  // limited spectrum requires. Headroom reduces the error of cubic interpolation.
+  static constexpr size_t mipmapOversample = 2;
+  static constexpr size_t minMipmapSize = 64;
+
   fftwf_complex *spectrum;
-  fftwf_complex *bandLimited;
   fftwf_complex *tmpSpec;
+  float *buffer = nullptr; // All rows are allocated on this contiguous memory.
+  std::shared_ptr<MappedTableFile> mappedFile; // Used instead of `buffer` when loaded.
   std::array<float *, nTablePadded> table;
-  std::array<fftwf_plan, nTablePadded> plan;
-  std::array<float, nTablePadded> frequency; // Must be sorted by ascending order.
-  bool isRefreshing = true;
+  std::array<size_t, nTablePadded> length;
+  std::array<int32_t, nTablePadded> offset;  // table[row] - table[0]. Used for gather.
+  std::array<float, nTablePadded> phaseScale; // length[row] / tableSize.
+  std::array<float, nTablePadded> frequency;  // Must be sorted by ascending order.
   float tableBaseFreq = 20.0f;
+  bool isMipmapped = false;
 
   Wavetable()
   {
     spectrum = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
-    bandLimited = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
     tmpSpec = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
 
     for (size_t idx = 0; idx < nTablePadded; ++idx) {
-      table[idx] = (float *)fftwf_malloc(sizeof(float) * paddedSize);
-      table[idx][0] = 0;
-      table[idx][paddedSize - 1] = 0;
-
-      plan[idx]
-        = fftwf_plan_dft_c2r_1d(tableSize, bandLimited, table[idx] + 1, FFTW_ESTIMATE);
-
       // TODO: Experiment with different frequency.
       frequency[idx] = 440.0f * powf(2.0f, (idx - 69.0f) / 12.0f);
     }
-
-    // Last 3 tables are slince.
-    for (size_t idx = nTablePadded - 3; idx < nTablePadded; ++idx) {
-      for (size_t i = 0; i < paddedSize; ++i) table[idx][i] = 0;
-    }
   }
 
   ~Wavetable()
   {
-    for (auto &pln : plan) fftwf_destroy_plan(pln);
-    for (auto &tbl : table) fftwf_free(tbl);
+    fftwf_free(buffer);
     fftwf_free(tmpSpec);
-    fftwf_free(bandLimited);
     fftwf_free(spectrum);
   }
 
@@ -129,36 +223,184 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     return powf(expf(-x * x) / bwi, shape);
   }
 
-  void refreshTable(float sampleRate)
+  size_t getBandIndex(size_t idx) const
   {
-    isRefreshing = true;
+    size_t bandIdx = size_t(spectrumSize * tableBaseFreq / frequency[idx]);
+    return std::clamp<size_t>(bandIdx, 1, spectrumSize);
+  }
 
-    // table[0] and table[1] has full spectrum.
-    bandLimited[0][0] = 0;
-    bandLimited[0][1] = 0;
-    std::memcpy(
-      bandLimited + 1, spectrum + 1, sizeof(fftwf_complex) * (spectrumSize - 1));
-    fftwf_execute(plan[0]);
-    std::memcpy(table[1], table[0], sizeof(float) * paddedSize);
+  void allocateTable(bool mipmap)
+  {
+    isMipmapped = mipmap;
 
+    // table[0] and table[1] has full spectrum. Last 3 tables are silence.
+    length[0] = tableSize;
+    length[1] = tableSize;
     for (size_t idx = 2; idx <= nTable; ++idx) {
-      size_t bandIdx = size_t(spectrumSize * tableBaseFreq / frequency[idx]);
-      bandIdx = std::clamp<size_t>(bandIdx, 1, spectrumSize);
+      if (!mipmap) {
+        length[idx] = tableSize;
+        continue;
+      }
+      size_t size = minMipmapSize;
+      while (size < 2 * mipmapOversample * getBandIndex(idx) && size < tableSize)
+        size *= 2;
+      length[idx] = size;
+    }
+    for (size_t idx = nTable + 1; idx < nTablePadded; ++idx) length[idx] = minMipmapSize;
 
-      bandLimited[0][0] = 0;
-      bandLimited[0][1] = 0;
-      std::memcpy(bandLimited + 1, spectrum + 1, sizeof(fftwf_complex) * (bandIdx - 1));
-      std::memset(
-        bandLimited + bandIdx, 0, sizeof(fftwf_complex) * (spectrumSize - bandIdx));
+    const size_t totalSize = getTotalSize();
 
-      fftwf_execute(plan[idx]);
+    mappedFile.reset();
+    fftwf_free(buffer);
+    buffer = (float *)fftwf_malloc(sizeof(float) * totalSize);
+    std::memset(buffer, 0, sizeof(float) * totalSize);
+    setRows(buffer);
+  }
+
+  size_t getTotalSize() const
+  {
+    size_t totalSize = 0;
+    for (const auto &len : length) totalSize += len + 3;
+    return totalSize;
+  }
+
+  void setRows(float *ptr)
+  {
+    int32_t rowOffset = 0;
+    for (size_t idx = 0; idx < nTablePadded; ++idx) {
+      table[idx] = ptr + rowOffset;
+      offset[idx] = rowOffset;
+      phaseScale[idx] = float(length[idx]) / float(tableSize);
+      rowOffset += int32_t(length[idx] + 3);
     }
+  }
+
+  // Header of the payload stored in TableDiskCache. Rows follow it.
+  struct CacheInfo {
+    float tableBaseFreq;
+    uint32_t isMipmapped;
+    std::array<uint64_t, nTablePadded> length;
+  };
+  CacheInfo cacheInfo; // Kept as member, because the disk write is queued.
+
+  // Rows point to the mapped file on success. Nothing is copied.
+  bool load(std::shared_ptr<MappedTableFile> file)
+  {
+    if (!file || file->size() < sizeof(CacheInfo)) return false;
+
+    CacheInfo info;
+    std::memcpy(&info, file->data(), sizeof(CacheInfo));
+    for (const auto &len : info.length)
+      if (len < minMipmapSize || len > tableSize) return false;
+    std::copy(info.length.begin(), info.length.end(), length.begin());
+    if (sizeof(CacheInfo) + sizeof(float) * getTotalSize() != file->size()) return false;
+
+    tableBaseFreq = info.tableBaseFreq;
+    isMipmapped = info.isMipmapped;
+
+    fftwf_free(buffer);
+    buffer = nullptr;
+    mappedFile = file;
+    setRows(reinterpret_cast<float *>(file->data() + sizeof(CacheInfo)));
+    return true;
+  }
+
+  // Queued write holds a reference to this table. Without an owner, it writes now.
+  void store(
+    TableDiskCache &cache,
+    uint64_t hash,
+    float sampleRate,
+    const std::vector<uint8_t> &config)
+  {
+    if (!cache.isEnabled()) return;
+
+    cacheInfo.tableBaseFreq = tableBaseFreq;
+    cacheInfo.isMipmapped = isMipmapped;
+    std::copy(length.begin(), length.end(), cacheInfo.length.begin());
+    cache.store(
+      hash, sampleRate, config, this->weak_from_this().lock(),
+      {{&cacheInfo, sizeof(CacheInfo)}, {table[0], sizeof(float) * getTotalSize()}});
+  }
+
+  // Maps the table from disk cache if available. Otherwise the table is computed and
+  // stored to the cache.
+  void padsynthWithCache(const PadSynthConfig<nPeak> &config)
+  {
+    auto &cache = wavetableDiskCache();
+    const auto hash = config.hash();
+    const auto bytes = config.serialize();
+    if (load(cache.load(hash, config.sampleRate, bytes))) return;
+    padsynth(config);
+    store(cache, hash, config.sampleRate, bytes);
+  }
+
+  // Rows are independent, so they are computed in parallel. Each worker has its own band
+  // limited spectrum. Plans are shared because `fftwf_execute_dft_c2r` is thread safe.
+  void refreshTable(float sampleRate, bool mipmap)
+  {
+    allocateTable(mipmap);
+
+    // table[0] and table[1] has full spectrum. table[1] is copied after the loop.
+    constexpr size_t nTask = nTable;
+    auto taskToRow = [](size_t task) { return task == 0 ? size_t(0) : task + 1; };
+
+    const size_t nWorker = getParallelWorkerCount(nTask);
+    std::vector<fftwf_complex *> bandLimited(nWorker);
+    for (auto &spec : bandLimited)
+      spec = (fftwf_complex *)fftwf_malloc(sizeof(fftwf_complex) * spectrumSize);
+
+    // Plans are reused for the rows which have the same length.
+    std::vector<std::pair<size_t, fftwf_plan>> plans;
+    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      for (size_t task = 0; task < nTask; ++task) {
+        const size_t idx = taskToRow(task);
+        auto found = std::find_if(plans.begin(), plans.end(), [&](const auto &pln) {
+          return pln.first == length[idx];
+        });
+        if (found != plans.end()) continue;
+        plans.emplace_back(
+          length[idx],
+          fftwf_plan_dft_c2r_1d(
+            length[idx], bandLimited[0], table[idx] + 1, FFTW_ESTIMATE | FFTW_UNALIGNED));
+      }
+    }
+    auto getPlan = [&](size_t idx) {
+      for (const auto &pln : plans)
+        if (pln.first == length[idx]) return pln.second;
+      return fftwf_plan(nullptr); // Unreachable.
+    };
+
+    parallelFor(nWorker, nTask, [&](size_t worker, size_t task) {
+      const size_t idx = taskToRow(task);
+
+      // Only the first `length / 2 + 1` bins are used by shorter row. Band limited
+      // spectrum fits in there.
+      size_t binSize = length[idx] / 2 + 1;
+      size_t bandIdx = idx == 0 ? spectrumSize : getBandIndex(idx);
+      bandIdx = std::min(bandIdx, binSize);
+
+      auto spec = bandLimited[worker];
+      spec[0][0] = 0;
+      spec[0][1] = 0;
+      std::memcpy(spec + 1, spectrum + 1, sizeof(fftwf_complex) * (bandIdx - 1));
+      std::memset(spec + bandIdx, 0, sizeof(fftwf_complex) * (binSize - bandIdx));
+
+      fftwf_execute_dft_c2r(getPlan(idx), spec, table[idx] + 1);
+    });
+    std::memcpy(table[1], table[0], sizeof(float) * paddedSize);
+
+    {
+      std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+      for (auto &pln : plans) fftwf_destroy_plan(pln.second);
+    }
+    for (auto &spec : bandLimited) fftwf_free(spec);
 
     // Fill padded elements.
     for (size_t idx = 0; idx < nTablePadded - 1; ++idx) {
-      table[idx][0] = table[idx][tableSize];
-      table[idx][paddedSize - 2] = table[idx][1];
-      table[idx][paddedSize - 1] = table[idx][2];
+      table[idx][0] = table[idx][length[idx]];
+      table[idx][length[idx] + 1] = table[idx][1];
+      table[idx][length[idx] + 2] = table[idx][2];
     }
 
     // Normalize.
@@ -169,31 +411,30 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     }
     if (max != 0.0f) {
       for (size_t idx = 0; idx < nTablePadded - 1; ++idx) {
-        for (size_t i = 0; i < paddedSize; ++i) table[idx][i] /= max;
+        for (size_t i = 0; i < length[idx] + 3; ++i) table[idx][i] /= max;
       }
     }
-
-    isRefreshing = false;
   }
 
   inline float sign(float x) { return (0 < x) - (x < 0); }
 
-  void padsynth(
-    float sampleRate,
-    float tableBaseFreq,
-    std::array<float, nPeak> &frequency,
-    std::array<float, nPeak> &gain,
-    std::array<float, nPeak> &phase,
-    std::array<float, nPeak> &bandWidth,
-    uint32_t seed,
-    float expand,
-    int32_t shift,
-    uint32_t profileSkip,
-    uint32_t profileShape,
-    bool randomPitch,
-    bool invertSpectrum,
-    bool uniformPhaseProfile)
+  void padsynth(const PadSynthConfig<nPeak> &config)
   {
+    const float sampleRate = config.sampleRate;
+    const float tableBaseFreq = config.tableBaseFreq;
+    const auto &frequency = config.frequency;
+    const auto &gain = config.gain;
+    const auto &phase = config.phase;
+    const auto &bandWidth = config.bandWidth;
+    const uint32_t seed = config.seed;
+    const float expand = config.expand;
+    int32_t shift = config.shift;
+    const uint32_t profileSkip = config.profileSkip;
+    const uint32_t profileShape = config.profileShape;
+    const bool randomPitch = config.randomPitch;
+    const bool invertSpectrum = config.invertSpectrum;
+    const bool uniformPhaseProfile = config.uniformPhaseProfile;
+
     this->tableBaseFreq = tableBaseFreq;
 
     for (int32_t bin = 0; bin < spectrumSize; ++bin) {
@@ -275,75 +516,7 @@ template<size_t tableSize, size_t nPeak> struct Wavetable {
     spectrum[0][0] = 0.0f;
     spectrum[0][1] = 0.0f;
 
-    refreshTable(sampleRate);
-  }
-};
-
-template<size_t tableSize> struct TableOsc {
-  static constexpr size_t paddedLast = tableSize + 1;
-  float phase = 1; // table index starts from 1. 0 is padded index.
-  float tick = 0;
-
-  void setFrequency(float sampleRate, float frequency, float tableBaseFreq)
-  {
-    tick = frequency / tableBaseFreq;
-    if (tick >= tableSize) tick = 0;
-  }
-
-  void reset() { phase = 1; }
-
-  // notePitch is fractional note number. For example, notePitch = 60.12 means 60
-  // semitones and 12 cents higher from midi note number 0.
-  float process(float notePitch, std::array<float *, nTablePadded> &table)
-  {
-    phase += tick;
-    if (phase > paddedLast) phase -= tableSize;
-
-    if (notePitch <= 0) {
-      float frac = phase - floor(phase);
-      size_t x1 = phase;
-      size_t x0 = x1 - 1;
-      size_t x2 = x1 + 1;
-      size_t x3 = x1 + 2;
-      return cubicInterp(table[0][x0], table[0][x1], table[0][x2], table[0][x3], frac);
-    } else if (notePitch >= notePitchUpperBound) {
-      return 0;
-    }
-    notePitch += 1.0f;
-
-    // // Bilinear interpolation.
-    // auto yFrac = notePitch - floor(notePitch);
-    // size_t south = size_t(notePitch);
-    // size_t north = south + 1;
-    // auto xFrac = phase - floor(phase);
-    // size_t L = size_t(phase);
-    // size_t R = L + 1;
-    // auto x0 = table[south][L] + xFrac * (table[south][R] - table[south][L]);
-    // auto x1 = table[north][L] + xFrac * (table[north][R] - table[north][L]);
-    // return x0 + yFrac * (x1 - x0);
-
-    // Bicubic interpolation.
-    auto yFrac = notePitch - floor(notePitch);
-    size_t iy1 = size_t(notePitch);
-    size_t iy0 = iy1 - 1;
-    size_t iy2 = iy1 + 1;
-    size_t iy3 = iy1 + 2;
-
-    auto xFrac = phase - floor(phase);
-    size_t ix1 = size_t(phase);
-    size_t ix0 = ix1 - 1;
-    size_t ix2 = ix1 + 1;
-    size_t ix3 = ix1 + 2;
-
-    auto y0 = cubicInterp(
-      table[iy0][ix0], table[iy0][ix1], table[iy0][ix2], table[iy0][ix3], xFrac);
-    auto y1 = cubicInterp(
-      table[iy1][ix0], table[iy1][ix1], table[iy1][ix2], table[iy1][ix3], xFrac);
-    auto y2 = cubicInterp(
-      table[iy2][ix0], table[iy2][ix1], table[iy2][ix2], table[iy2][ix3], xFrac);
-    auto y3 = cubicInterp(
-      table[iy3][ix0], table[iy3][ix1], table[iy3][ix2], table[iy3][ix3], xFrac);
-    return cubicInterp(y0, y1, y2, y3, yFrac);
+    refreshTable(sampleRate, config.mipmap);
   }
 };
 
@@ -374,22 +547,60 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
 
   void reset() { phase = 1; }
 
-  inline Vec16f loadTable(Vec16i ix, Vec16i iy, std::array<float *, nTablePadded> &table)
+  void copyLane(int index, const TableOsc16 &src, int srcIndex)
+  {
+    phase.insert(index, src.phase[srcIndex]);
+    tick.insert(index, src.tick[srcIndex]);
+  }
+
+#if INSTRSET >= 8
+  // All rows are on a contiguous memory, so a single gather can read different rows.
+  // `row` is an offset from `table.table[0]`.
+  template<typename Table> inline Vec16i rowBase(Vec16i iy, const Table &table)
+  {
+    return lookup<nTablePadded>(iy, table.offset.data());
+  }
+
+  template<typename Table>
+  inline Vec16f loadTable(Vec16i ix, Vec16i row, const Table &table)
+  {
+    return lookup<std::numeric_limits<int32_t>::max()>(row + ix, table.table[0]);
+  }
+#else
+  // SSE2 and SSE4.1 don't have gather, and VCL emulates it slower than `extract`. `row`
+  // is a row index.
+  template<typename Table> inline Vec16i rowBase(Vec16i iy, const Table &)
   {
+    return iy;
+  }
+
+  template<typename Table>
+  inline Vec16f loadTable(Vec16i ix, Vec16i row, const Table &table)
+  {
+    const auto &tbl = table.table;
     return Vec16f(
-      table[iy.extract(0)][ix.extract(0)], table[iy.extract(1)][ix.extract(1)],
-      table[iy.extract(2)][ix.extract(2)], table[iy.extract(3)][ix.extract(3)],
-      table[iy.extract(4)][ix.extract(4)], table[iy.extract(5)][ix.extract(5)],
-      table[iy.extract(6)][ix.extract(6)], table[iy.extract(7)][ix.extract(7)],
-      table[iy.extract(8)][ix.extract(8)], table[iy.extract(9)][ix.extract(9)],
-      table[iy.extract(10)][ix.extract(10)], table[iy.extract(11)][ix.extract(11)],
-      table[iy.extract(12)][ix.extract(12)], table[iy.extract(13)][ix.extract(13)],
-      table[iy.extract(14)][ix.extract(14)], table[iy.extract(15)][ix.extract(15)]);
+      tbl[row.extract(0)][ix.extract(0)], tbl[row.extract(1)][ix.extract(1)],
+      tbl[row.extract(2)][ix.extract(2)], tbl[row.extract(3)][ix.extract(3)],
+      tbl[row.extract(4)][ix.extract(4)], tbl[row.extract(5)][ix.extract(5)],
+      tbl[row.extract(6)][ix.extract(6)], tbl[row.extract(7)][ix.extract(7)],
+      tbl[row.extract(8)][ix.extract(8)], tbl[row.extract(9)][ix.extract(9)],
+      tbl[row.extract(10)][ix.extract(10)], tbl[row.extract(11)][ix.extract(11)],
+      tbl[row.extract(12)][ix.extract(12)], tbl[row.extract(13)][ix.extract(13)],
+      tbl[row.extract(14)][ix.extract(14)], tbl[row.extract(15)][ix.extract(15)]);
+  }
+#endif
+
+  // Scales phase to the length of mipmapped row. When scale is 1, `phase - 1` and `+ 1`
+  // are exact, so the index is the same as non-mipmapped table.
+  template<typename Table> inline Vec16f rowPhase(Vec16i iy, const Table &table)
+  {
+    return (phase - float(1)) * lookup<nTablePadded>(iy, table.phaseScale.data())
+      + float(1);
   }
 
   // notePitch is fractional note number. For example, notePitch = 60.12 means 60
   // semitones and 12 cents higher from midi note number 0.
-  Vec16f process(Vec16f notePitch, std::array<float *, nTablePadded> &table)
+  template<typename Table> Vec16f process(Vec16f notePitch, const Table &table)
   {
     phase += tick;
     phase = select(phase >= paddedLast, phase - tableSize, phase);
@@ -403,23 +614,40 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
     Vec16i iy0 = truncatei(notePitch);
     Vec16i iy1 = iy0 + 1;
 
-    Vec16f xFrac = phase - floor(phase);
-    Vec16i ix0 = truncatei(phase);
-    Vec16i ix1 = ix0 + 1;
-
-    Vec16f table00 = loadTable(ix0, iy0, table);
-    Vec16f table01 = loadTable(ix1, iy0, table);
-    Vec16f y0 = table00 + xFrac * (table01 - table00);
-
-    Vec16f table10 = loadTable(ix0, iy1, table);
-    Vec16f table11 = loadTable(ix1, iy1, table);
-    Vec16f y1 = table10 + xFrac * (table11 - table10);
+    Vec16f x0 = rowPhase(iy0, table);
+    Vec16f xFrac0 = x0 - floor(x0);
+    Vec16i row0 = rowBase(iy0, table);
+    Vec16i ix0 = truncatei(x0);
+    Vec16f table00 = loadTable(ix0, row0, table);
+    Vec16f table01 = loadTable(ix0 + 1, row0, table);
+    Vec16f y0 = table00 + xFrac0 * (table01 - table00);
+
+    Vec16f x1 = rowPhase(iy1, table);
+    Vec16f xFrac1 = x1 - floor(x1);
+    Vec16i row1 = rowBase(iy1, table);
+    Vec16i ix1 = truncatei(x1);
+    Vec16f table10 = loadTable(ix1, row1, table);
+    Vec16f table11 = loadTable(ix1 + 1, row1, table);
+    Vec16f y1 = table10 + xFrac1 * (table11 - table10);
 
     return y0 + yFrac * (y1 - y0);
   }
 
-  // Too slow.
-  Vec16f processCubic(Vec16f notePitch, std::array<float *, nTablePadded> &table)
+  template<typename Table> inline Vec16f interpRow(Vec16i iy, const Table &table)
+  {
+    Vec16f x = rowPhase(iy, table);
+    Vec16f xFrac = x - floor(x);
+    Vec16i row = rowBase(iy, table);
+    Vec16i ix1 = truncatei(x);
+
+    Vec16f table0 = loadTable(ix1 - 1, row, table);
+    Vec16f table1 = loadTable(ix1, row, table);
+    Vec16f table2 = loadTable(ix1 + 1, row, table);
+    Vec16f table3 = loadTable(ix1 + 2, row, table);
+    return cubicInterp(table0, table1, table2, table3, xFrac);
+  }
+
+  template<typename Table> Vec16f processCubic(Vec16f notePitch, const Table &table)
   {
     phase += tick;
     phase = select(phase >= paddedLast, phase - tableSize, phase);
@@ -431,40 +659,11 @@ template<size_t tableSize> struct alignas(64) TableOsc16 {
     // Bicubic interpolation.
     Vec16f yFrac = notePitch - floor(notePitch);
     Vec16i iy1 = truncatei(notePitch);
-    Vec16i iy0 = iy1 - 1;
-    Vec16i iy2 = iy1 + 1;
-    Vec16i iy3 = iy1 + 2;
-
-    Vec16f xFrac = phase - floor(phase);
-    Vec16i ix1 = truncatei(phase);
-    Vec16i ix0 = ix1 - 1;
-    Vec16i ix2 = ix1 + 1;
-    Vec16i ix3 = ix1 + 2;
-
-    Vec16f table00 = loadTable(ix0, iy0, table);
-    Vec16f table01 = loadTable(ix1, iy0, table);
-    Vec16f table02 = loadTable(ix2, iy0, table);
-    Vec16f table03 = loadTable(ix3, iy0, table);
-    Vec16f y0 = cubicInterp(table00, table01, table02, table03, xFrac);
-
-    Vec16f table10 = loadTable(ix0, iy1, table);
-    Vec16f table11 = loadTable(ix1, iy1, table);
-    Vec16f table12 = loadTable(ix2, iy1, table);
-    Vec16f table13 = loadTable(ix3, iy1, table);
-    Vec16f y1 = cubicInterp(table10, table11, table12, table13, xFrac);
-
-    Vec16f table20 = loadTable(ix0, iy2, table);
-    Vec16f table21 = loadTable(ix1, iy2, table);
-    Vec16f table22 = loadTable(ix2, iy2, table);
-    Vec16f table23 = loadTable(ix3, iy2, table);
-    Vec16f y2 = cubicInterp(table20, table21, table22, table23, xFrac);
-
-    Vec16f table30 = loadTable(ix0, iy3, table);
-    Vec16f table31 = loadTable(ix1, iy3, table);
-    Vec16f table32 = loadTable(ix2, iy3, table);
-    Vec16f table33 = loadTable(ix3, iy3, table);
-    Vec16f y3 = cubicInterp(table30, table31, table32, table33, xFrac);
 
+    Vec16f y0 = interpRow(iy1 - 1, table);
+    Vec16f y1 = interpRow(iy1, table);
+    Vec16f y2 = interpRow(iy1 + 1, table);
+    Vec16f y3 = interpRow(iy1 + 2, table);
     return cubicInterp(y0, y1, y2, y3, yFrac);
   }
 };
@@ -536,6 +735,12 @@ public:
   void reset() { phase = 0; }
   void reset(int index) { phase.insert(index, 0); }
 
+  void copyLane(int index, const LfoTableOsc16 &src, int srcIndex)
+  {
+    phase.insert(index, src.phase[srcIndex]);
+    tick.insert(index, src.tick[srcIndex]);
+  }
+
   inline Vec16f loadTable(Vec16i ix, std::array<float, tableSize + 1> &table)
   {
     return Vec16f(
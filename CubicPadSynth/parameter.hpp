@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -124,6 +125,8 @@ enum ID {
   refreshLFO,
   refreshTable,
 
+  tableMipmap,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -372,6 +375,9 @@ struct GlobalParameter : public ParameterInterface {
       0, Scales::boolScale, "refreshLFO", kParameterIsAutomable | kParameterIsBoolean);
     value[ID::refreshTable] = std::make_unique<IntValue>(
       0, Scales::boolScale, "refreshTable", kParameterIsAutomable | kParameterIsBoolean);
+
+    value[ID::tableMipmap] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "tableMipmap", kParameterIsAutomable | kParameterIsBoolean);
   }
 
 #ifndef TEST_BUILD
@@ -478,9 +484,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 
   void validate()
   {
@@ -18,8 +18,6 @@
 #include "parameter.hpp"
 
 // Generated from preset dump.
-#ifndef TEST_BUILD
-
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -40720,5 +40718,3 @@ void GlobalParameter::loadProgram(uint32_t index)
     } break;
   }
 }
-
-#endif
@@ -582,6 +582,11 @@ public:
       addCheckbox(
         tableSpectrumLeft0, tableSpectrumTop + 5.0f * labelY, checkboxWidth, labelHeight,
         uiTextSize, "Invert", ID::spectrumInvert));
+    tabview->addWidget(
+      tabPadSynth,
+      addCheckbox(
+        tableSpectrumLeft1, tableSpectrumTop + 5.0f * labelY, checkboxWidth, labelHeight,
+        uiTextSize, "Mipmap", ID::tableMipmap));
 
     const auto tablePhaseTop = tableSpectrumTop + 6.0f * labelY;
     const auto tablePhaseLeft0 = tablePitchLeft0;
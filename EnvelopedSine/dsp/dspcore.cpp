@@ -305,44 +305,47 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
   SmootherCommon<float>::setBufferSize(length);
 
   std::array<float, 2> frame{};
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    frame.fill(0.0f);
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      frame.fill(0.0f);
 
-    for (auto &note : notes) {
-      if (note.state == NoteState::rest) continue;
-      auto noteOut = note.process();
-      frame[0] += noteOut[0];
-      frame[1] += noteOut[1];
-    }
+      for (auto &note : notes) {
+        if (note.state == NoteState::rest) continue;
+        auto noteOut = note.process();
+        frame[0] += noteOut[0];
+        frame[1] += noteOut[1];
+      }
 
-    if (isTransitioning) {
-      frame[0] += transitionBuffer[trIndex][0];
-      frame[1] += transitionBuffer[trIndex][1];
-      transitionBuffer[trIndex].fill(0.0f);
-      trIndex = (trIndex + 1) % transitionBuffer.size();
-      if (trIndex == trStop) isTransitioning = false;
-    }
+      if (isTransitioning) {
+        frame[0] += transitionBuffer[trIndex][0];
+        frame[1] += transitionBuffer[trIndex][1];
+        transitionBuffer[trIndex].fill(0.0f);
+        trIndex = (trIndex + 1) % transitionBuffer.size();
+        if (trIndex == trStop) isTransitioning = false;
+      }
 
-    const auto phaserFreq = interpPhaserTick.process();
-    const auto phaserFeedback = interpPhaserFeedback.process();
-    const auto phaserRange = interpPhaserRange.process();
-    const auto phaserMin = interpPhaserMin.process();
-    const auto phaserPhase = interpPhaserPhase.process();
-    const auto phaserOffset = interpPhaserOffset.process();
-    phaser[0].setup(phaserPhase, phaserFreq, phaserFeedback, phaserRange, phaserMin);
-    phaser[1].setup(
-      phaserPhase + phaserOffset, phaserFreq, phaserFeedback, phaserRange, phaserMin);
-
-    const auto phaserMix = interpPhaserMix.process();
-    frame[0] += phaserMix * (phaser[0].process(frame[0]) - frame[0]);
-    frame[1] += phaserMix * (phaser[1].process(frame[1]) - frame[1]);
-
-    const auto masterGain = interpMasterGain.process();
-    out0[i] = masterGain * frame[0];
-    out1[i] = masterGain * frame[1];
+      const auto phaserFreq = interpPhaserTick.process();
+      const auto phaserFeedback = interpPhaserFeedback.process();
+      const auto phaserRange = interpPhaserRange.process();
+      const auto phaserMin = interpPhaserMin.process();
+      const auto phaserPhase = interpPhaserPhase.process();
+      const auto phaserOffset = interpPhaserOffset.process();
+      phaser[0].setup(phaserPhase, phaserFreq, phaserFeedback, phaserRange, phaserMin);
+      phaser[1].setup(
+        phaserPhase + phaserOffset, phaserFreq, phaserFeedback, phaserRange, phaserMin);
+
+      const auto phaserMix = interpPhaserMix.process();
+      frame[0] += phaserMix * (phaser[0].process(frame[0]) - frame[0]);
+      frame[1] += phaserMix * (phaser[1].process(frame[1]) - frame[1]);
+
+      const auto masterGain = interpMasterGain.process();
+      out0[i] = masterGain * frame[0];
+      out1[i] = masterGain * frame[1];
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float velocity)
@@ -63,8 +63,6 @@ IntScale<double> Scales::nVoice(5);
 LogScale<double> Scales::smoothness(0.0, 0.5, 0.1, 0.04);
 
 // Generated from preset dump. This works, but hard coding preset data is seriously bad.
-#ifndef TEST_BUILD
-
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -9158,4 +9156,3 @@ void GlobalParameter::loadProgram(uint32_t index)
     } break;
   }
 }
-#endif
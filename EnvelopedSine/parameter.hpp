@@ -21,6 +21,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -400,9 +401,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 
   void validate()
   {
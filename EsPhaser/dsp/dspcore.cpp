@@ -34,6 +34,15 @@
   #error Unsupported instruction set
 #endif
 
+// Kernel width of StereoThiranPhaser, which is the width of SIMD register.
+#if INSTRSET >= 10
+using PhaserVec = Vec16f;
+#elif INSTRSET >= 8
+using PhaserVec = Vec8f;
+#else
+using PhaserVec = Vec4f;
+#endif
+
 inline float clamp(float value, float min, float max)
 {
   return (value < min) ? min : (value > max) ? max : value;
@@ -60,21 +69,20 @@ void DSPCORE_NAME::setup(double sampleRate)
 
   interpPhase.setRange(float(twopi));
 
-  phaser[0].setup(sampleRate);
-  phaser[1].setup(sampleRate);
+  phaser.setup(sampleRate);
   startup();
 }
 
 void DSPCORE_NAME::reset()
 {
-  for (auto &ph : phaser) ph.reset();
+  phaser.reset();
   startup();
 }
 
 void DSPCORE_NAME::startup()
 {
-  for (size_t i = 0; i < phaser.size(); ++i) {
-    phaser[i].phase = float(i) / phaser.size();
+  for (size_t i = 0; i < StereoThiranPhaser::nChannel; ++i) {
+    phaser.setPhase(i, float(i) / StereoThiranPhaser::nChannel);
   }
 }
 
@@ -104,23 +112,22 @@ void DSPCORE_NAME::setParameters(float tempo)
 
   const float phaserRange = param.value[ID::range]->getFloat();
   interpRange.push(phaserRange);
-  interpMin.push(Thiran2Phaser::getLfoMin(phaserRange, param.value[ID::min]->getFloat()));
+  interpMin.push(
+    StereoThiranPhaser::getLfoMin(phaserRange, param.value[ID::min]->getFloat()));
 
   interpPhase.push(param.value[ID::phase]->getFloat());
   interpStereoOffset.push(param.value[ID::stereoOffset]->getFloat());
   interpCascadeOffset.push(param.value[ID::cascadeOffset]->getFloat());
 
   auto phaserStage = param.value[ID::stage]->getInt();
-  phaser[0].setStage(phaserStage);
-  phaser[1].setStage(phaserStage);
+  phaser.setStage(phaserStage);
 }
 
 void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
   SmootherCommon<float>::setBufferSize(length);
-  phaser[0].interpStage.setBufferSize(length);
-  phaser[1].interpStage.setBufferSize(length);
+  phaser.setBufferSize(length);
 
   for (size_t i = 0; i < length; ++i) {
     const auto freq = interpTick.process();
@@ -132,13 +139,12 @@ void DSPCORE_NAME::process(
     const auto stereo = interpStereoOffset.process();
     const auto cascade = interpCascadeOffset.process();
 
-    const auto phaser0
-      = phaser[0].process(in0[i], spread, cascade, phase, freq, feedback, range, min);
-    const auto phaser1 = phaser[1].process(
-      in0[i], spread, cascade, phase + stereo, freq, feedback, range, min);
+    const auto sig = phaser.process<PhaserVec>(
+      {in0[i], in0[i]}, spread, cascade, {phase, phase + stereo}, freq, feedback, range,
+      min);
 
     const auto mix = interpMix.process();
-    out0[i] = in0[i] + mix * (phaser0 - in0[i]);
-    out1[i] = in1[i] + mix * (phaser1 - in1[i]);
+    out0[i] = in0[i] + mix * (sig[0] - in0[i]);
+    out1[i] = in1[i] + mix * (sig[1] - in1[i]);
   }
 }
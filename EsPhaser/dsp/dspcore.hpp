@@ -63,7 +63,7 @@ public:
   private:                                                                               \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
-    std::array<Thiran2Phaser, 2> phaser;                                                 \
+    StereoThiranPhaser phaser;                                                           \
                                                                                          \
     LinearSmoother<float> interpMix;                                                     \
     LinearSmoother<float> interpTick;                                                    \
@@ -23,8 +23,10 @@
 #include "../../lib/vcl/vectorclass.h"
 #include "../../lib/vcl/vectormath_trig.h"
 
+#include <algorithm>
 #include <array>
-#include <iostream>
+#include <cstddef>
+#include <vector>
 
 namespace SomeDSP {
 
@@ -82,60 +84,34 @@ protected:
   Sample epsilon = 1e-5;
 };
 
-struct alignas(64) ThiranAllpass2x16 {
-  Vec16f x0 = 0.0f;
-  Vec16f x1 = 0.0f;
-  Vec16f x2 = 0.0f;
-  Vec16f y0 = 0.0f;
-  Vec16f y1 = 0.0f;
-  Vec16f y2 = 0.0f;
-  Vec16f a1 = 0.0f;
-  Vec16f a2 = 0.0f;
+/**
+Cascade of 2nd order Thiran allpasses for both channels in a single pipeline.
 
-  void reset()
-  {
-    x0 = 0.0f;
-    x1 = 0.0f;
-    x2 = 0.0f;
-    y0 = 0.0f;
-    y1 = 0.0f;
-    y2 = 0.0f;
-  }
+A stage has 16 allpasses in lanes. Lane `k` filters the input of the stage delayed by
+`k` samples, and lane 15 feeds the next stage. This is the same as `Thiran2Phaser` of
+older versions, which had a pair of it for each channel, and shifted lanes with
+`permute16` in every stage.
 
-  // fraction > 0.01.
-  void step(float input, Vec16f fraction)
-  {
-    auto delay = 2.0f - fraction;
-    auto tmp = (delay - 2.0f) / (delay + 1.0f);
-    a1 = -2.0f * tmp;
-    a2 = (delay - 1.0f) / (delay + 2.0f) * tmp;
-
-    x2 = x1;
-    x1 = x0;
-    x0 = permute16<V_DC, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14>(x0);
-    x0.insert(0, input);
-
-    y2 = y1;
-    y1 = y0;
-    y0 = a2 * x0 + a1 * x1 + x2 - a1 * y1 - a2 * y2;
-  }
-
-  float get(int index) { return y0.extract(index); }
-};
+Here, lanes in all stages share coefficients, so they are computed once per sample for
+each channel. Input history of a stage is stored in a ring buffer with mirror, and its
+write pointer is shared by all stages. Then `x0`, `x1` and `x2` of all lanes are
+contiguous loads at the write pointer, and no shift is needed.
 
-struct alignas(64) Thiran2Phaser {
-  std::array<ThiranAllpass2x16, 256> allpass;
-  Vec16f phase{0};
-  float buffer = 0;
-  float sampleRate = 44100;
-  std::array<int, 2> stage{15, 15};
-  std::array<int, 2> index{};
-  int arrayStop = 255;
-  LinearSmootherRampLocal<float> interpStage;
+`process` takes VCL vector type `V` of 4, 8 or 16 floats, which is the width of
+allpass kernel. DSPCore passes the native width of each instruction set. Members are
+plain floats, so that the layout doesn't depend on instruction set.
+*/
+class StereoThiranPhaser {
+public:
+  static constexpr size_t nChannel = 2;
+  static constexpr size_t nLane = 16;
+  static constexpr size_t nStage = 256;
 
   // Convert UI value to DSP value. Used to set offset outside of main processing loop.
   static float getLfoMin(float range, float min) { return min + range - 0.99f; }
 
+  // Stages which are skipped while `arrayStop` is low start from silence when enabled
+  // again.
   void setStage(int newStage)
   {
     if (newStage < 0) return;
@@ -147,7 +123,9 @@ struct alignas(64) Thiran2Phaser {
     index[0] = index[1];
     index[1] = newStage >> 4;
 
+    const int lastStop = arrayStop;
     arrayStop = index[0] > index[1] ? index[0] : index[1];
+    for (int i = lastStop + 1; i <= arrayStop; ++i) resetStage(i);
 
     stage[0] = stage[1];
     stage[1] = newStage - (arrayStop << 4);
@@ -155,54 +133,122 @@ struct alignas(64) Thiran2Phaser {
 
   void setup(float sampleRate)
   {
-    this->sampleRate = sampleRate;
     interpStage.setSampleRate(sampleRate);
     interpStage.setTime(0.04f);
     interpStage.reset(1.0f);
   }
 
+  void setBufferSize(size_t length) { interpStage.setBufferSize(length); }
+
+  void setPhase(size_t channel, float value) { phase[channel].fill(value); }
+
   void reset()
   {
-    for (auto &ap : allpass) ap.reset();
-    buffer = 0;
+    std::fill(arena.begin(), arena.end(), 0.0f);
+    buffer.fill(0.0f);
   }
 
   // tick = frequency / sampleRate.
   // Stable only if (lfoRange - lfoMin) <= 0.99f.
-  float process(
-    float input,
+  template<typename V>
+  std::array<float, nChannel> process(
+    const std::array<float, nChannel> &input,
     float freqSpread,
     float cascadeOffset,
-    float stereoOffset,
+    const std::array<float, nChannel> &stereoOffset,
     float tick,
     float feedback,
     float lfoRange,
     float lfoMin)
   {
-    Vec16f tck;
-    Vec16f offset;
-    for (int i = 0; i < 16; ++i) {
-      tck.insert(i, freqSpread * i);
-      offset.insert(i, stereoOffset + i * cascadeOffset);
+    constexpr size_t width = V::size();
+    static_assert(nLane % width == 0, "Width of V must divide the number of lanes.");
+
+    const Vec16f lane(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const Vec16f tck = freqSpread * lane;
+    for (size_t ch = 0; ch < nChannel; ++ch) {
+      Vec16f phs = Vec16f().load_a(phase[ch].data());
+      phs += tick / (1.0f + tck);
+      phs = select(phs > float(pi), phs - float(twopi), phs);
+      phs.store_a(phase[ch].data());
+
+      // Fraction of Thiran allpass. It must be greater than 0.01.
+      const Vec16f offset = stereoOffset[ch] + lane * cascadeOffset;
+      const Vec16f lfo = lfoRange * sin(phs + offset) - lfoMin;
+
+      auto delay = 2.0f - lfo;
+      auto tmp = (delay - 2.0f) / (delay + 1.0f);
+      (-2.0f * tmp).store_a(a1[ch].data());
+      ((delay - 1.0f) / (delay + 2.0f) * tmp).store_a(a2[ch].data());
+
+      buffer[ch]
+        = juce::dsp::FastMathApproximations::tanh(input[ch] + feedback * buffer[ch]);
     }
 
-    phase += tick / (1.0f + tck);
-    phase = select(phase > float(pi), phase - float(twopi), phase);
-
-    Vec16f lfo = lfoRange * sin(phase + offset) - lfoMin;
+    wptr = wptr == 0 ? historyLength - 1 : wptr - 1;
+    parity ^= 1;
+    const size_t yNew = historyLength + nMirror + parity * nLane;
+    const size_t yOld = historyLength + nMirror + (parity ^ 1) * nLane;
 
-    buffer = juce::dsp::FastMathApproximations::tanh(input + feedback * buffer);
     for (int i = 0; i <= arrayStop; ++i) {
-      allpass[i].step(buffer, lfo);
-      buffer = allpass[i].get(15);
+      for (size_t ch = 0; ch < nChannel; ++ch) {
+        float *data = arena.data() + (i * nChannel + ch) * stride;
+
+        data[wptr] = buffer[ch];
+        if (wptr < nMirror) data[wptr + historyLength] = buffer[ch];
+
+        // y0 overwrites y2.
+        const float *x = data + wptr;
+        float *y0 = data + yNew;
+        const float *y1 = data + yOld;
+        for (size_t k = 0; k < nLane; k += width) {
+          const V c1 = V().load_a(a1[ch].data() + k);
+          const V c2 = V().load_a(a2[ch].data() + k);
+          const V x0 = V().load(x + k);
+          const V x1 = V().load(x + k + 1);
+          const V x2 = V().load(x + k + 2);
+          (c2 * x0 + c1 * x1 + x2 - c1 * V().load(y1 + k) - c2 * V().load(y0 + k))
+            .store(y0 + k);
+        }
+
+        buffer[ch] = y0[nLane - 1];
+      }
     }
 
-    auto sig0 = allpass[index[0]].get(stage[0]);
-    auto sig1 = allpass[index[1]].get(stage[1]);
-    buffer = sig0 + interpStage.process() * (sig1 - sig0);
-
+    const float ratio = interpStage.process();
+    for (size_t ch = 0; ch < nChannel; ++ch) {
+      const float sig0 = arena[(index[0] * nChannel + ch) * stride + yNew + stage[0]];
+      const float sig1 = arena[(index[1] * nChannel + ch) * stride + yNew + stage[1]];
+      buffer[ch] = sig0 + ratio * (sig1 - sig0);
+    }
     return buffer;
   }
+
+private:
+  // Lane 15 reads `x2`, which is 17 samples before the latest input.
+  static constexpr size_t nMirror = nLane + 1;
+  static constexpr size_t historyLength = 64 - nMirror;
+
+  // A stage of a channel has input history, and 2 slots of outputs for `y1` and `y2`.
+  static constexpr size_t stride = historyLength + nMirror + 2 * nLane;
+
+  void resetStage(int i)
+  {
+    auto begin = arena.begin() + i * nChannel * stride;
+    std::fill(begin, begin + nChannel * stride, 0.0f);
+  }
+
+  alignas(64) std::array<std::array<float, nLane>, nChannel> phase{};
+  alignas(64) std::array<std::array<float, nLane>, nChannel> a1{};
+  alignas(64) std::array<std::array<float, nLane>, nChannel> a2{};
+  std::vector<float> arena = std::vector<float>(nStage * nChannel * stride, 0.0f);
+  std::array<float, nChannel> buffer{};
+  size_t wptr = 0;
+  size_t parity = 0;
+  std::array<int, 2> stage{15, 15};
+  std::array<int, 2> index{};
+  int arrayStop = nStage - 1;
+  LinearSmootherRampLocal<float> interpStage;
 };
 
 } // namespace SomeDSP
@@ -37,7 +37,6 @@ IntScale<double> Scales::tempoDenominator(255);
 LogScale<double> Scales::frequencyMultiplier(0.0, 16.0, 0.5, 1.0);
 
 // Generated from preset dump. This works, but hard coding preset data is seriously bad.
-#ifndef TEST_BUILD
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -228,4 +227,3 @@ void GlobalParameter::loadProgram(uint32_t index)
     } break;
   }
 }
-#endif
@@ -21,6 +21,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -218,9 +219,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 
   void validate()
   {
@@ -17,138 +17,238 @@
 
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <memory>
 #include <numeric>
 #include <vector>
 
+#include "../../common/dsp/delay.hpp"
 #include "../../common/dsp/smoother.hpp"
 
+#include "../../lib/vcl/vectorclass.h"
+
 namespace SomeDSP {
 
-// 2x oversampled, linear interpolated delay.
-template<typename Sample> class Delay {
+/**
+Feedback delay network with up to 16 delays, processed as Vec16f. Lanes from `matrixSize`
+to 15 are padding. Their gain and matrix entries are 0, so they stay silent.
+
+`matrix` and `gain` are staging area. Call `updateMatrix` after writing them.
+
+- Random mode uses `matrix` as is. Row `i` is the sum of matrix columns scaled by
+  `delayOut`, added from column 0 in the same order as the scalar implementation.
+- Householder mode uses `s * (I - 2 u u^T / (u^T u))` instead, where `u` is the
+  diagonal of `matrix` and `s` is RMS of singular values of `matrix`. It's orthogonal
+  up to `s`, and costs O(matrixSize) instead of O(matrixSize^2).
+
+Delays are 2x oversampled like OversampledDelay. Their buffers are interleaved, so a
+sample of all delays is written at once. Tap indices of all delays are computed as a
+Vec16i. AVX2 and AVX512 read the taps with gather. SSE2 and SSE4.1 don't have gather, so
+the taps of used lanes are read in a scalar loop over the stored indices, which is faster
+than VCL's gather emulation. Delay times are smoothed per lane in the same way as
+LinearSmoother.
+*/
+template<size_t matrixSize> class FeedbackDelayNetwork {
 public:
-  void setup(double sampleRate, Sample time, Sample maxTime)
-  {
-    this->sampleRate = 2 * sampleRate;
+  static_assert(matrixSize <= 16, "Delays must fit in Vec16f.");
 
-    auto size = size_t(this->sampleRate * maxTime);
-    buf.resize(size >= INT32_MAX ? INT32_MAX : size + 1);
+  static constexpr size_t nLane = 16;
 
-    setTime(time);
-    reset();
+  std::array<std::array<float, matrixSize>, matrixSize> matrix{};
+  std::array<float, matrixSize> gain{};
+
+  FeedbackDelayNetwork()
+  {
+    std::array<int32_t, nLane> index;
+    for (size_t i = 0; i < nLane; ++i) index[i] = int32_t(i);
+    laneIndex.load(index.data());
   }
 
-  void setTime(Sample seconds)
+  void setup(float sampleRate, float maxTime = 0.5)
   {
-    auto timeInSample
-      = std::max<Sample>(0, std::min<Sample>(sampleRate * seconds, (Sample)buf.size()));
+    this->sampleRate = 2.0f * sampleRate;
 
-    size_t timeInt = size_t(timeInSample);
-    rFraction = timeInSample - Sample(timeInt);
+    length = size_t(this->sampleRate * maxTime) + 1;
+    size_t newSize = 1;
+    while (newSize < length) newSize *= 2;
+    mask = newSize - 1;
+    buf.resize(newSize * nLane);
 
-    // Possible negative overflow. rptr must be in [0, buf.size()).
-    rptr = wptr - timeInt;
-    while (rptr >= buf.size()) rptr += buf.size();
+    setTime(Vec16f(maxTime));
+    reset();
   }
 
-  Sample getTime()
+  void reset()
   {
-    auto diff = rptr < wptr ? wptr - rptr : wptr + buf.size() - rptr;
-    return diff / sampleRate;
+    std::fill(buf.begin(), buf.end(), 0.0f);
+    wptr = 0;
+    w1 = 0;
+    delayOut = 0;
+
+    gain.fill(1);
+    for (size_t i = 0; i < matrixSize; ++i) {
+      matrix[i].fill(0);
+      matrix[i][i] = 1;
+    }
+    updateMatrix();
   }
 
-  void reset()
+  void setHouseholder(bool enable)
   {
-    std::fill(buf.begin(), buf.end(), 0);
-    w1 = 0.0;
+    if (enable == isHouseholder) return;
+    isHouseholder = enable;
+    updateMatrix();
   }
 
-  Sample process(const Sample input)
+  void updateMatrix()
   {
-    // Write to buffer.
-    buf[wptr] = input - Sample(0.5) * (input - w1);
-    wptr += 1;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    buf[wptr] = input;
-    wptr += 1;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    w1 = input;
+    std::array<float, nLane> lane{};
+    for (size_t i = 0; i < matrixSize; ++i) lane[i] = gain[i];
+    gainVec.load(lane.data());
 
-    // Read from buffer.
-    const size_t i1 = rptr;
-    rptr += 1;
-    if (rptr >= buf.size()) rptr -= buf.size();
-
-    const size_t i0 = rptr;
-    rptr += 1;
-    if (rptr >= buf.size()) rptr -= buf.size();
+    if (!isHouseholder) {
+      for (size_t j = 0; j < matrixSize; ++j) {
+        for (size_t i = 0; i < matrixSize; ++i) lane[i] = matrix[i][j];
+        column[j].load(lane.data());
+      }
+      return;
+    }
 
-    return buf[i0] - rFraction * (buf[i0] - buf[i1]);
+    double norm2 = 0; // Squared Frobenius norm.
+    double uu = 0;
+    for (size_t i = 0; i < matrixSize; ++i) {
+      for (size_t j = 0; j < matrixSize; ++j) norm2 += matrix[i][j] * matrix[i][j];
+      lane[i] = matrix[i][i];
+      uu += double(lane[i]) * double(lane[i]);
+    }
+    if (uu < 1e-6) {
+      for (size_t i = 0; i < matrixSize; ++i) lane[i] = 1;
+      uu = double(matrixSize);
+    }
+    householderU.load(lane.data());
+    householderScale = float(std::sqrt(norm2 / matrixSize));
+    householderC = float(2.0 / uu);
   }
 
-protected:
-  Sample sampleRate = 44100.0;
-  Sample rFraction = 0.0;
-  Sample w1 = 0.0;
-  size_t wptr = 0;
-  size_t rptr = 0;
-  std::vector<Sample> buf{2};
-};
-
-template<typename Sample, size_t matrixSize> class FeedbackDelayNetwork {
-public:
-  Sample sampleRate;
-  std::array<Delay<Sample>, matrixSize> delay;
-  std::array<LinearSmoother<Sample>, matrixSize> delayTime;
-  std::array<Sample, matrixSize> gain{};
-  std::array<Sample, matrixSize> buffer{};
-  std::array<Sample, matrixSize> delayOut{};
-  std::array<std::array<Sample, matrixSize>, matrixSize> matrix;
-
-  void setup(Sample sampleRate, Sample maxTime = 0.5)
-  {
-    this->sampleRate = sampleRate;
-    for (auto &dly : delay) dly.setup(sampleRate, maxTime, maxTime);
-    for (auto dlyTime : delayTime) dlyTime.reset(maxTime);
-    reset();
+  // Pushes target time of delay `index` to smoother.
+  void setDelayTime(size_t index, float seconds)
+  {
+    timeTarget.insert(index, seconds);
+    if (Common::timeInSamples < Common::bufferSize) {
+      timeValue.insert(index, seconds);
+      timeRamp.insert(index, 0.0f);
+    } else {
+      timeRamp.insert(
+        index, (seconds - timeValue.extract(index)) / Common::timeInSamples);
+    }
   }
 
-  void reset()
+  // Same as `refresh` of LinearSmoother.
+  void refreshDelayTime()
   {
-    for (auto &dly : delay) dly.reset();
-
-    gain.fill(1);
-    buffer.fill(0);
-    delayOut.fill(0);
-
-    for (size_t i = 0; i < matrixSize; ++i) {
-      for (size_t j = 0; j < matrixSize; ++j) {
-        if (i == j)
-          matrix[i][j] = 1;
-        else
-          matrix[i][j] = 0;
-      }
+    if (Common::timeInSamples < Common::bufferSize) {
+      timeValue = timeTarget;
+      timeRamp = 0;
+    } else {
+      timeRamp = (timeTarget - timeValue) / Common::timeInSamples;
     }
   }
 
-  Sample process(Sample input)
+  float process(float input)
   {
-    buffer.fill(0);
-
-    for (size_t i = 0; i < matrixSize; ++i) {
-      for (size_t j = 0; j < matrixSize; ++j) buffer[i] += matrix[i][j] * delayOut[j];
+    Vec16f buffer;
+    if (isHouseholder) {
+      const float dot = horizontal_add(householderU * delayOut);
+      buffer = householderScale * (delayOut - (householderC * dot) * householderU);
+    } else {
+      buffer = 0;
+      for (size_t j = 0; j < matrixSize; ++j)
+        buffer += column[j] * delayOut[int(j)];
     }
 
+    timeValue += timeRamp;
+    timeValue = select(abs(timeValue - timeTarget) < 1e-5f, timeTarget, timeValue);
+    setTime(timeValue);
+
+    const Vec16f x = gainVec * (buffer + input);
+    float *row = buf.data() + wptr * nLane;
+    (x - 0.5f * (x - w1)).store(row);
+    wptr = (wptr + 1) & mask;
+    x.store(buf.data() + wptr * nLane);
+    wptr = (wptr + 1) & mask;
+    w1 = x;
+
+    const Vec16i latest = int32_t(wptr) - 1;
+    const Vec16i imask = int32_t(mask);
+    const Vec16i index0 = (((latest - newer) & imask) << 4) + laneIndex;
+    const Vec16i index1 = (((latest - older) & imask) << 4) + laneIndex;
+#if INSTRSET >= 8
+    const Vec16f x0 = lookup<std::numeric_limits<int32_t>::max()>(index0, buf.data());
+    const Vec16f x1 = lookup<std::numeric_limits<int32_t>::max()>(index1, buf.data());
+#else
+    // Padding lanes are left at 0, which is what they hold in `buf`.
+    alignas(64) std::array<int32_t, nLane> i0;
+    alignas(64) std::array<int32_t, nLane> i1;
+    alignas(64) std::array<float, nLane> tap0{};
+    alignas(64) std::array<float, nLane> tap1{};
+    index0.store_a(i0.data());
+    index1.store_a(i1.data());
     for (size_t i = 0; i < matrixSize; ++i) {
-      delay[i].setTime(delayTime[i].process());
-      delayOut[i] = delay[i].process(gain[i] * (buffer[i] + input));
+      tap0[i] = buf[i0[i]];
+      tap1[i] = buf[i1[i]];
     }
+    Vec16f x0;
+    Vec16f x1;
+    x0.load_a(tap0.data());
+    x1.load_a(tap1.data());
+#endif
+    delayOut = x0 - rFraction * (x0 - x1);
+
+    std::array<float, nLane> out;
+    delayOut.store(out.data());
+    return std::accumulate(out.begin(), out.begin() + matrixSize, 0.0f);
+  }
+
+private:
+  using Common = SmootherCommon<float>;
 
-    return std::accumulate(delayOut.begin(), delayOut.end(), Sample(0));
+  // Same as `setTime` of OversampledDelay.
+  void setTime(const Vec16f &seconds)
+  {
+    const Vec16f timeInSample = min(max(sampleRate * seconds, 0.0f), float(length));
+    const Vec16i timeInt = truncatei(timeInSample);
+    rFraction = timeInSample - to_float(timeInt);
+
+    const Vec16i len = int32_t(length);
+    newer = select(timeInt >= len, timeInt - len, timeInt);
+    older = newer + 1;
+    older = select(older >= len, older - len, older);
   }
+
+  float sampleRate = 44100;
+  size_t length = 1;
+  size_t mask = 0;
+  size_t wptr = 0;
+  bool isHouseholder = false;
+  float householderScale = 1;
+  float householderC = 0;
+
+  Vec16i laneIndex;
+  Vec16i newer = 0; // Delay of taps in oversampled samples.
+  Vec16i older = 0;
+  Vec16f rFraction = 0;
+  Vec16f w1 = 0;
+  Vec16f delayOut = 0;
+  Vec16f gainVec = 0;
+  Vec16f householderU = 0;
+  Vec16f timeValue = 1;
+  Vec16f timeTarget = 1;
+  Vec16f timeRamp = 0;
+  std::array<Vec16f, matrixSize> column{};
+  std::vector<float> buf;
 };
 
 // Schroeder allpass filter
@@ -160,7 +260,7 @@ template<typename Sample> class LongAllpass {
 public:
   Sample gain = 1;
   Sample buffer = 0;
-  Delay<Sample> delay;
+  OversampledDelay<Sample> delay;
   LinearSmoother<Sample> delayTime;
 
   void setup(Sample sampleRate, Sample maxTime)
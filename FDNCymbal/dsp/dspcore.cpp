@@ -18,6 +18,18 @@
 #include "dspcore.hpp"
 #include "../../lib/juce_FastMathApproximations.h"
 
+#if INSTRSET >= 10
+  #define DSPCORE_NAME DSPCore_AVX512
+#elif INSTRSET >= 8
+  #define DSPCORE_NAME DSPCore_AVX2
+#elif INSTRSET >= 5
+  #define DSPCORE_NAME DSPCore_SSE41
+#elif INSTRSET == 2
+  #define DSPCORE_NAME DSPCore_SSE2
+#else
+  #error Unsupported instruction set
+#endif
+
 inline float clamp(float value, float min, float max)
 {
   return (value < min) ? min : (value > max) ? max : value;
@@ -28,9 +40,12 @@ inline float midiNoteToFrequency(float pitch, float tuning)
   return 440.0f * powf(2.0f, ((pitch - 69.0f) * 100.0f + tuning) / 1200.0f);
 }
 
-float paramToPitch(float bend) { return powf(2.0f, ((bend - 0.5f) * 400.0f) / 1200.0f); }
+inline float paramToPitch(float bend)
+{
+  return powf(2.0f, ((bend - 0.5f) * 400.0f) / 1200.0f);
+}
 
-void DSPCore::setup(double sampleRate)
+void DSPCORE_NAME::setup(double sampleRate)
 {
   this->sampleRate = sampleRate;
 
@@ -46,7 +61,7 @@ void DSPCore::setup(double sampleRate)
   for (auto &osc : stickOscillator) osc.setup(sampleRate, 100.0f);
   velvet.setup(sampleRate, sampleRate * 0.004, 0);
 
-  for (auto &fdn : fdnCascade) fdn.setup(sampleRate, 0.5f);
+  for (auto &fdn : fdnCascade) fdn.setup(sampleRate, fdnMaxTime);
 
   serialAP1.setup(sampleRate, 0.01f);
   for (auto &ap : serialAP2) ap.setup(sampleRate, 0.01f);
@@ -55,6 +70,9 @@ void DSPCore::setup(double sampleRate)
 
   tremoloDelay.setup(sampleRate, tremoloDelayMaxTime, tremoloDelayMaxTime);
 
+  // Residue in a delay buffer comes out within its length.
+  silence.setup(sampleRate, 2 * fdnMaxTime);
+
   interpFDNFeedback.reset(param.value[ParameterID::fdnFeedback]->getFloat());
   interpFDNCascadeMix.reset(param.value[ParameterID::fdnCascadeMix]->getFloat());
   interpAllpassMix.reset(param.value[ParameterID::allpassMix]->getFloat());
@@ -71,9 +89,9 @@ void DSPCore::setup(double sampleRate)
   startup();
 }
 
-void DSPCore::free() {}
+void DSPCORE_NAME::free() {}
 
-void DSPCore::reset()
+void DSPCORE_NAME::reset()
 {
   serialAP1Sig = 0.0f;
   serialAP1.reset();
@@ -88,20 +106,23 @@ void DSPCore::reset()
 
   tremoloDelay.reset();
 
+  silence.reset();
+
   startup();
 }
 
-void DSPCore::startup()
+void DSPCORE_NAME::startup()
 {
   rng.seed = param.value[ParameterID::seed]->getInt();
   tremoloPhase = 0.0f;
 }
 
-void DSPCore::setParameters()
+void DSPCORE_NAME::setParameters()
 {
   using ID = ParameterID::ID;
 
   SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  silence.setEnabled(param.value[ID::autoSleep]->getInt());
 
   if (!noteStack.empty()) {
     velocity = noteStack.back().velocity;
@@ -137,86 +158,105 @@ void DSPCore::setParameters()
     param.value[ID::allpass2HighpassCutoff]->getFloat(), highpassQ);
 }
 
-void DSPCore::process(
+void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
+  // Note-on wakes up DSP, so sleep only when there's no event.
+  if (silence.isSleeping(length, in0, in1) && midiNotes.empty()) {
+    std::fill(out0, out0 + length, 0.0f);
+    std::fill(out1, out1 + length, 0.0f);
+    return;
+  }
+
   SmootherCommon<float>::setBufferSize(length);
 
-  for (auto &fdn : fdnCascade)
-    for (auto &time : fdn.delayTime) time.refresh();
+  const bool fdnHouseholder = param.value[ParameterID::fdnMatrix]->getInt();
+  for (auto &fdn : fdnCascade) {
+    fdn.setHouseholder(fdnHouseholder);
+    fdn.refreshDelayTime();
+  }
   for (auto &ap : serialAP1.allpass) ap.delayTime.refresh();
   for (auto &section : serialAP2)
     for (auto &ap : section.allpass) ap.delayTime.refresh();
 
   const bool enableFDN = param.value[ParameterID::fdn]->getInt();
   const bool allpass1Saturation = param.value[ParameterID::allpass1Saturation]->getInt();
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    float sample = 0.0f;
-    if (in0 != nullptr) sample += in0[i];
-    if (in1 != nullptr) sample += in1[i];
-
-    const float pitch = interpPitch.process();
-    if (!stickEnvelope.isTerminated) {
-      const float toneMix = interpStickToneMix.process();
-      const float pulseMix = interpStickPulseMix.process();
-      const float velvetMix = interpStickVelvetMix.process();
-      const float stickEnv = stickEnvelope.process();
-      float stickTone = 0.0f;
-      for (auto &osc : stickOscillator) stickTone += osc.process();
-      velvet.setDensity(pitch);
-      sample += pulseMix * pulsar.process()
-        + stickEnv * (toneMix * stickTone + velvetMix * velvet.process());
-    }
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      float sample = 0.0f;
+      if (in0 != nullptr) sample += in0[i];
+      if (in1 != nullptr) sample += in1[i];
+
+      const float pitch = interpPitch.process();
+      if (!stickEnvelope.isTerminated) {
+        const float toneMix = interpStickToneMix.process();
+        const float pulseMix = interpStickPulseMix.process();
+        const float velvetMix = interpStickVelvetMix.process();
+        const float stickEnv = stickEnvelope.process();
+        float stickTone = 0.0f;
+        for (auto &osc : stickOscillator) stickTone += osc.process();
+        velvet.setDensity(pitch);
+        sample += pulseMix * pulsar.process()
+          + stickEnv * (toneMix * stickTone + velvetMix * velvet.process());
+      }
 
-    // FDN.
-    if (enableFDN) {
-      const float fdnFeedback = interpFDNFeedback.process();
-      fdnSig = fdnCascade[0].process(
-        juce::dsp::FastMathApproximations::tanh<float>(sample + fdnFeedback * fdnSig));
-      const float fdnCascadeMix = interpFDNCascadeMix.process();
-      for (size_t j = 1; j < fdnCascade.size(); ++j)
-        fdnSig = fdnSig + fdnCascadeMix * (fdnCascade[j].process(fdnSig * 2.0f) - fdnSig);
-      sample = fdnSig * 1024.0;
-    }
+      // FDN.
+      if (enableFDN) {
+        const float fdnFeedback = interpFDNFeedback.process();
+        fdnSig = fdnCascade[0].process(
+          juce::dsp::FastMathApproximations::tanh<float>(sample + fdnFeedback * fdnSig));
+        const float fdnCascadeMix = interpFDNCascadeMix.process();
+        for (size_t j = 1; j < fdnCascade.size(); ++j)
+          fdnSig
+            = fdnSig + fdnCascadeMix * (fdnCascade[j].process(fdnSig * 2.0f) - fdnSig);
+        sample = fdnSig * 1024.0;
+      }
 
-    // Allpass.
-    serialAP1Sig = allpass1Saturation
-      ? juce::dsp::FastMathApproximations::tanh(serialAP1Sig)
-      : serialAP1Sig;
-    serialAP1Sig
-      = serialAP1.process(sample + interpAllpass1Feedback.process() * serialAP1Sig);
-    float apOut = serialAP1Highpass.process(serialAP1Sig);
-
-    serialAP2Sig = apOut + interpAllpass2Feedback.process() * serialAP2Sig;
-    float sum = 0.0f;
-    for (auto &ap : serialAP2) sum += ap.process(serialAP2Sig);
-    serialAP2Sig = sum / serialAP2.size();
-    apOut += 4.0f * serialAP2Highpass.process(serialAP2Sig);
-
-    const float allpassMix = interpAllpassMix.process();
-    sample += allpassMix * (apOut - sample);
-
-    // Tremolo.
-    tremoloPhase += interpTremoloFrequency.process() * float(twopi) / sampleRate;
-    if (tremoloPhase >= float(twopi)) tremoloPhase -= float(twopi);
-
-    const float tremoloLFO = 0.5f * (sinf(tremoloPhase) + 1.0f);
-    tremoloDelay.setTime(interpTremoloDelayTime.process() * tremoloLFO);
-
-    const float tremoloDepth = interpTremoloDepth.process();
-    sample += interpTremoloMix.process()
-      * ((tremoloDepth * tremoloLFO + 1.0f - tremoloDepth) * tremoloDelay.process(sample)
-         - sample);
-
-    const float masterGain = interpMasterGain.process();
-    out0[i] = masterGain * sample;
-    out1[i] = masterGain * sample;
+      // Allpass.
+      serialAP1Sig = allpass1Saturation
+        ? juce::dsp::FastMathApproximations::tanh(serialAP1Sig)
+        : serialAP1Sig;
+      serialAP1Sig
+        = serialAP1.process(sample + interpAllpass1Feedback.process() * serialAP1Sig);
+      float apOut = serialAP1Highpass.process(serialAP1Sig);
+
+      serialAP2Sig = apOut + interpAllpass2Feedback.process() * serialAP2Sig;
+      float sum = 0.0f;
+      for (auto &ap : serialAP2) sum += ap.process(serialAP2Sig);
+      serialAP2Sig = sum / serialAP2.size();
+      apOut += 4.0f * serialAP2Highpass.process(serialAP2Sig);
+
+      const float allpassMix = interpAllpassMix.process();
+      sample += allpassMix * (apOut - sample);
+
+      // Tremolo.
+      tremoloPhase += interpTremoloFrequency.process() * float(twopi) / sampleRate;
+      if (tremoloPhase >= float(twopi)) tremoloPhase -= float(twopi);
+
+      const float tremoloLFO = 0.5f * (sinf(tremoloPhase) + 1.0f);
+      tremoloDelay.setTime(interpTremoloDelayTime.process() * tremoloLFO);
+
+      const float tremoloDepth = interpTremoloDepth.process();
+      sample += interpTremoloMix.process()
+        * ((tremoloDepth * tremoloLFO + 1.0f - tremoloDepth)
+             * tremoloDelay.process(sample)
+           - sample);
+
+      silence.track(sample);
+
+      const float masterGain = interpMasterGain.process();
+      out0[i] = masterGain * sample;
+      out1[i] = masterGain * sample;
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
+
+  silence.endBlock(length);
 }
 
-void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
+void DSPCORE_NAME::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
 {
   NoteInfo info;
   info.id = noteId;
@@ -224,6 +264,8 @@ void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity
   info.velocity = velocity;
   noteStack.push_back(info);
 
+  silence.wake();
+
   const auto seed = param.value[ParameterID::seed]->getInt();
 
   // Set stick oscillator.
@@ -265,9 +307,10 @@ void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity
       }
       fdnCascade[n].gain[i] = (rng.process() < 0.5f ? 1.0f : -1.0f)
         * (0.1f + rng.process()) * 2.0f / fdnMatrixSize;
-      fdnCascade[n].delayTime[i].push(
-        rng.process() * delayTimeMod * param.value[ParameterID::fdnTime]->getFloat());
+      fdnCascade[n].setDelayTime(
+        i, rng.process() * delayTimeMod * param.value[ParameterID::fdnTime]->getFloat());
     }
+    fdnCascade[n].updateMatrix();
   }
 
   // Set serialAP.
@@ -298,7 +341,7 @@ void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity
       * (rngTremolo.process() - 1.0f);
 }
 
-void DSPCore::noteOff(int32_t noteId)
+void DSPCORE_NAME::noteOff(int32_t noteId)
 {
   auto it = std::find_if(noteStack.begin(), noteStack.end(), [&](const NoteInfo &info) {
     return info.id == noteId;
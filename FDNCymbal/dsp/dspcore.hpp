@@ -18,6 +18,8 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
+#include "../../common/dsp/silencedetector.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
@@ -25,6 +27,8 @@
 #include "iir.hpp"
 #include "oscillator.hpp"
 
+#include "../../lib/vcl/vectorclass.h"
+
 #include <array>
 #include <cmath>
 #include <memory>
@@ -35,6 +39,7 @@ constexpr size_t fdnMatrixSize = 12;
 constexpr size_t nAP1 = 8;
 constexpr size_t nAP2 = 8;
 constexpr double highpassQ = 0.01;
+constexpr float fdnMaxTime = 0.5f;
 constexpr float tremoloDelayMaxTime = 0.001f;
 
 struct NoteInfo {
@@ -43,20 +48,23 @@ struct NoteInfo {
   float velocity;
 };
 
-class DSPCore {
+class DSPInterface {
 public:
+  virtual ~DSPInterface(){};
+
   static const size_t maxVoice = 32;
   GlobalParameter param;
 
-  void setup(double sampleRate);
-  void free();    // Release memory.
-  void reset();   // Stop sounds.
-  void startup(); // Reset phase, random seed etc.
-  void setParameters();
-  void process(
-    const size_t length, const float *in0, const float *in1, float *out0, float *out1);
-  void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity);
-  void noteOff(int32_t noteId);
+  virtual void setup(double sampleRate) = 0;
+  virtual void free() = 0;    // Release memory.
+  virtual void reset() = 0;   // Stop sounds.
+  virtual void startup() = 0; // Reset phase, random seed etc.
+  virtual void setParameters() = 0;
+  virtual void process(
+    const size_t length, const float *in0, const float *in1, float *out0, float *out1)
+    = 0;
+  virtual void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) = 0;
+  virtual void noteOff(int32_t noteId) = 0;
 
   struct MidiNote {
     bool isNoteOn;
@@ -67,85 +75,115 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
-  void pushMidiNote(
+  virtual void pushMidiNote(
     bool isNoteOn,
     uint32_t frame,
     int32_t noteId,
     int16_t pitch,
     float tuning,
     float velocity)
-  {
-    MidiNote note;
-    note.isNoteOn = isNoteOn;
-    note.frame = frame;
-    note.id = noteId;
-    note.pitch = pitch;
-    note.tuning = tuning;
-    note.velocity = velocity;
-    midiNotes.push_back(note);
-  }
-
-  void processMidiNote(uint32_t frame)
-  {
-    while (true) {
-      auto it = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {
-        return nt.frame == frame;
-      });
-      if (it == std::end(midiNotes)) return;
-      if (it->isNoteOn)
-        noteOn(it->id, it->pitch, it->tuning, it->velocity);
-      else
-        noteOff(it->id);
-      midiNotes.erase(it);
-    }
-  }
-
-private:
-  float sampleRate = 44100.0f;
-
-  float velocity = 0;
-  std::vector<NoteInfo> noteStack; // Top of this stack is current note.
-
-  Random<float> rng{0};
-  Random<float> rngStick{0};
-  Random<float> rngTremolo{0};
-  Pulsar<float> pulsar{44100.0f, 0.0f};
-
-  ExpDecay<float> stickEnvelope;
-  std::array<BiquadOsc<float>, 16> stickOscillator;
-  VelvetNoise<float> velvet;
-
-  float fdnSig = 0.0f;
-  std::array<FeedbackDelayNetwork<float, fdnMatrixSize>, 8> fdnCascade;
-
-  float serialAP1Sig = 0.0f;
-  SerialAllpass<float, nAP1> serialAP1;
-  BiquadHighPass<double> serialAP1Highpass;
-
-  float serialAP2Sig = 0.0f;
-  std::array<SerialAllpass<float, nAP2>, 4> serialAP2;
-  BiquadHighPass<double> serialAP2Highpass;
+    = 0;
+  virtual void processMidiNote(uint32_t frame) = 0;
+};
 
-  Delay<float> tremoloDelay;
-  float tremoloPhase = 0.0f;
-  float randomTremoloDepth = 0.0f;
-  float randomTremoloFrequency = 0.0f;
-  float randomTremoloDelayTime = 0.0f;
+#define DSPCORE_CLASS(INSTRSET)                                                          \
+  class DSPCore_##INSTRSET final : public DSPInterface {                                 \
+  public:                                                                                \
+    void setup(double sampleRate) override;                                              \
+    void free() override;                                                                \
+    void reset() override;                                                               \
+    void startup() override;                                                             \
+    void setParameters() override;                                                       \
+    void process(                                                                        \
+      const size_t length,                                                               \
+      const float *in0,                                                                  \
+      const float *in1,                                                                  \
+      float *out0,                                                                       \
+      float *out1) override;                                                             \
+    void noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity) override;   \
+    void noteOff(int32_t noteId) override;                                               \
+                                                                                         \
+    void pushMidiNote(                                                                   \
+      bool isNoteOn,                                                                     \
+      uint32_t frame,                                                                    \
+      int32_t noteId,                                                                    \
+      int16_t pitch,                                                                     \
+      float tuning,                                                                      \
+      float velocity) override                                                           \
+    {                                                                                    \
+      MidiNote note;                                                                     \
+      note.isNoteOn = isNoteOn;                                                          \
+      note.frame = frame;                                                                \
+      note.id = noteId;                                                                  \
+      note.pitch = pitch;                                                                \
+      note.tuning = tuning;                                                              \
+      note.velocity = velocity;                                                          \
+      midiNotes.push(note);                                                              \
+    }                                                                                    \
+                                                                                         \
+    void processMidiNote(uint32_t frame) override                                        \
+    {                                                                                    \
+      midiNotes.dispatch(frame, [&](const MidiNote &nt) {                                \
+        if (nt.isNoteOn)                                                                 \
+          noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);                               \
+        else                                                                             \
+          noteOff(nt.id);                                                                \
+      });                                                                                \
+    }                                                                                    \
+                                                                                         \
+  private:                                                                               \
+    float sampleRate = 44100.0f;                                                         \
+                                                                                         \
+    float velocity = 0;                                                                  \
+    std::vector<NoteInfo> noteStack; /* Top of this stack is current note. */            \
+                                                                                         \
+    Random<float> rng{0};                                                                \
+    Random<float> rngStick{0};                                                           \
+    Random<float> rngTremolo{0};                                                         \
+    Pulsar<float> pulsar{44100.0f, 0.0f};                                                \
+                                                                                         \
+    ExpDecay<float> stickEnvelope;                                                       \
+    std::array<BiquadOsc<float>, 16> stickOscillator;                                    \
+    VelvetNoise<float> velvet;                                                           \
+                                                                                         \
+    float fdnSig = 0.0f;                                                                 \
+    std::array<FeedbackDelayNetwork<fdnMatrixSize>, 8> fdnCascade;                       \
+                                                                                         \
+    float serialAP1Sig = 0.0f;                                                           \
+    SerialAllpass<float, nAP1> serialAP1;                                                \
+    BiquadHighPass<double> serialAP1Highpass;                                            \
+                                                                                         \
+    float serialAP2Sig = 0.0f;                                                           \
+    std::array<SerialAllpass<float, nAP2>, 4> serialAP2;                                 \
+    BiquadHighPass<double> serialAP2Highpass;                                            \
+                                                                                         \
+    OversampledDelay<float> tremoloDelay;                                                \
+    float tremoloPhase = 0.0f;                                                           \
+    float randomTremoloDepth = 0.0f;                                                     \
+    float randomTremoloFrequency = 0.0f;                                                 \
+    float randomTremoloDelayTime = 0.0f;                                                 \
+                                                                                         \
+    LinearSmoother<float> interpPitch;                                                   \
+    LinearSmoother<float> interpStickToneMix;                                            \
+    LinearSmoother<float> interpStickPulseMix;                                           \
+    LinearSmoother<float> interpStickVelvetMix;                                          \
+    LinearSmoother<float> interpFDNFeedback;                                             \
+    LinearSmoother<float> interpFDNCascadeMix;                                           \
+    LinearSmoother<float> interpAllpassMix;                                              \
+    LinearSmoother<float> interpAllpass1Feedback;                                        \
+    LinearSmoother<float> interpAllpass2Feedback;                                        \
+    LinearSmoother<float> interpTremoloMix;                                              \
+    LinearSmoother<float> interpTremoloDepth;                                            \
+    LinearSmoother<float> interpTremoloFrequency;                                        \
+    LinearSmoother<float> interpTremoloDelayTime;                                        \
+    LinearSmoother<float> interpMasterGain;                                              \
+                                                                                         \
+    SilenceDetector silence;                                                             \
+  };
 
-  LinearSmoother<float> interpPitch;
-  LinearSmoother<float> interpStickToneMix;
-  LinearSmoother<float> interpStickPulseMix;
-  LinearSmoother<float> interpStickVelvetMix;
-  LinearSmoother<float> interpFDNFeedback;
-  LinearSmoother<float> interpFDNCascadeMix;
-  LinearSmoother<float> interpAllpassMix;
-  LinearSmoother<float> interpAllpass1Feedback;
-  LinearSmoother<float> interpAllpass2Feedback;
-  LinearSmoother<float> interpTremoloMix;
-  LinearSmoother<float> interpTremoloDepth;
-  LinearSmoother<float> interpTremoloFrequency;
-  LinearSmoother<float> interpTremoloDelayTime;
-  LinearSmoother<float> interpMasterGain;
-};
+DSPCORE_CLASS(AVX512)
+DSPCORE_CLASS(AVX2)
+DSPCORE_CLASS(SSE41)
+DSPCORE_CLASS(SSE2)
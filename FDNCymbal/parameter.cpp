@@ -27,6 +27,7 @@ IntScale<double> Scales::seed(16777215); // 2^24 - 1
 LogScale<double> Scales::fdnTime(0.0001, 0.5, 0.5, 0.1);
 LogScale<double> Scales::fdnFeedback(0.0, 4.0, 0.75, 1.0);
 LogScale<double> Scales::fdnCascadeMix(0.0, 1.0, 0.5, 0.2);
+IntScale<double> Scales::fdnMatrix(1);
 LogScale<double> Scales::allpassTime(0.0, 0.005, 0.5, 0.001);
 LogScale<double> Scales::allpassFeedback(0.0, 0.9999, 0.5, 0.9);
 LogScale<double> Scales::allpassHighpassCutoff(1.0, 40.0, 0.5, 10.0);
@@ -80,6 +81,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case preset0: {
@@ -113,6 +115,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case preset11415258: {
@@ -146,6 +149,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case preset5711006: {
@@ -179,6 +183,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetFDNTweak: {
@@ -212,6 +217,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetGlassy: {
@@ -245,6 +251,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetLongExcitation: {
@@ -278,6 +285,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetRandomShortTime: {
@@ -311,6 +319,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetRetriggerStickOscillator: {
@@ -344,6 +353,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetSmooth: {
@@ -377,6 +387,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.3479999601840973);
       value[ID::gain]->setFromNormalized(0.49625468254089355);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetTooMuchDelayTime: {
@@ -410,6 +421,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
 
     case presetTurnRight: {
@@ -443,6 +455,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::smoothness]->setFromNormalized(0.1);
       value[ID::gain]->setFromNormalized(0.5861423015594482);
       value[ID::pitchBend]->setFromNormalized(0.5);
+      value[ID::fdnMatrix]->setFromInt(0);
     } break;
   }
 }
@@ -20,6 +20,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -68,6 +69,9 @@ enum ID {
   gain,
   pitchBend,
 
+  fdnMatrix,
+  autoSleep,
+
   ID_ENUM_LENGTH,
 };
 } // namespace ParameterID
@@ -80,6 +84,7 @@ struct Scales {
   static SomeDSP::LogScale<double> fdnTime;
   static SomeDSP::LogScale<double> fdnFeedback;
   static SomeDSP::LogScale<double> fdnCascadeMix;
+  static SomeDSP::IntScale<double> fdnMatrix;
   static SomeDSP::LogScale<double> allpassTime;
   static SomeDSP::LogScale<double> allpassFeedback;
   static SomeDSP::LogScale<double> allpassHighpassCutoff;
@@ -181,6 +186,11 @@ struct GlobalParameter : public ParameterInterface {
       = std::make_unique<LogValue>(0.5, Scales::gain, "gain", kParameterIsAutomable);
     value[ID::pitchBend] = std::make_unique<LinearValue>(
       0.5, Scales::defaultScale, "pitchBend", kParameterIsAutomable);
+
+    value[ID::fdnMatrix] = std::make_unique<IntValue>(
+      0, Scales::fdnMatrix, "fdnMatrix", kParameterIsAutomable | kParameterIsInteger);
+    value[ID::autoSleep] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "autoSleep", kParameterIsAutomable | kParameterIsBoolean);
   }
 
 #ifndef TEST_BUILD
@@ -279,7 +289,7 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 };
@@ -20,6 +20,9 @@
 // You should have received a copy of the GNU General Public License
 // along with FDNCymbal.  If not, see <https://www.gnu.org/licenses/>.
 
+#include <iostream>
+
+#include <memory>
 #include <utility>
 
 #include "DistrhoPlugin.hpp"
@@ -33,9 +36,23 @@ public:
   FDNCymbal()
     : Plugin(ParameterID::ID_ENUM_LENGTH, GlobalParameter::Preset::Preset_ENUM_LENGTH, 0)
   {
+    auto iset = instrset_detect();
+    if (iset >= 10) {
+      dsp = std::make_unique<DSPCore_AVX512>();
+    } else if (iset >= 8) {
+      dsp = std::make_unique<DSPCore_AVX2>();
+    } else if (iset >= 5) {
+      dsp = std::make_unique<DSPCore_SSE41>();
+    } else if (iset >= 2) {
+      dsp = std::make_unique<DSPCore_SSE2>();
+    } else {
+      std::cerr << "\nError: Instruction set SSE2 not supported on this computer";
+      exit(EXIT_FAILURE);
+    }
+
     sampleRateChanged(getSampleRate());
-    lastNoteId.reserve(dsp.maxVoice + 1);
-    alreadyRecievedNote.reserve(dsp.maxVoice);
+    lastNoteId.reserve(dsp->maxVoice + 1);
+    alreadyRecievedNote.reserve(dsp->maxVoice);
   }
 
 protected:
@@ -60,7 +77,7 @@ protected:
 
   void initParameter(uint32_t index, Parameter &parameter) override
   {
-    dsp.param.initParameter(index, parameter);
+    dsp->param.initParameter(index, parameter);
 
     switch (index) {
       case ParameterID::bypass:
@@ -73,24 +90,24 @@ protected:
 
   float getParameterValue(uint32_t index) const override
   {
-    return dsp.param.getFloat(index);
+    return dsp->param.getFloat(index);
   }
 
   void setParameterValue(uint32_t index, float value) override
   {
-    dsp.param.setParameterValue(index, value);
+    dsp->param.setParameterValue(index, value);
   }
 
   void initProgramName(uint32_t index, String &programName) override
   {
-    dsp.param.initProgramName(index, programName);
+    dsp->param.initProgramName(index, programName);
   }
 
-  void loadProgram(uint32_t index) override { dsp.param.loadProgram(index); }
+  void loadProgram(uint32_t index) override { dsp->param.loadProgram(index); }
 
-  void sampleRateChanged(double newSampleRate) { dsp.setup(newSampleRate); }
-  void activate() { dsp.startup(); }
-  void deactivate() { dsp.reset(); }
+  void sampleRateChanged(double newSampleRate) { dsp->setup(newSampleRate); }
+  void activate() { dsp->startup(); }
+  void deactivate() { dsp->reset(); }
 
   void handleMidi(const MidiEvent ev)
   {
@@ -104,7 +121,7 @@ protected:
           lastNoteId.begin(), lastNoteId.end(),
           [&](const std::pair<uint8_t, uint32_t> &p) { return p.first == ev.data[1]; });
         if (it == std::end(lastNoteId)) break;
-        dsp.pushMidiNote(false, ev.frame, it->second, 0, 0, 0);
+        dsp->pushMidiNote(false, ev.frame, it->second, 0, 0, 0);
         lastNoteId.erase(it);
       } break;
 
@@ -115,7 +132,7 @@ protected:
             alreadyRecievedNote.begin(), alreadyRecievedNote.end(),
             [&](const uint8_t &noteNo) { return noteNo == ev.data[1]; });
           if (it != std::end(alreadyRecievedNote)) break;
-          dsp.pushMidiNote(
+          dsp->pushMidiNote(
             true, ev.frame, noteId, ev.data[1], 0.0f, ev.data[2] / float(INT8_MAX));
           lastNoteId.push_back(std::pair<uint8_t, uint32_t>(ev.data[1], noteId));
           alreadyRecievedNote.push_back(ev.data[1]);
@@ -125,7 +142,7 @@ protected:
 
       // Pitch bend. Center is 8192 (0x2000).
       case 0xe0:
-        dsp.param.value[ParameterID::pitchBend]->setFromFloat(
+        dsp->param.value[ParameterID::pitchBend]->setFromFloat(
           ((uint16_t(ev.data[2]) << 7) + ev.data[1]) / 16384.0f);
         break;
 
@@ -143,21 +160,21 @@ protected:
   {
     if (inputs == nullptr) return;
     if (outputs == nullptr) return;
-    if (dsp.param.value[ParameterID::bypass]->getInt()) return;
+    if (dsp->param.value[ParameterID::bypass]->getInt()) return;
 
     const auto timePos = getTimePosition();
-    if (!wasPlaying && timePos.playing) dsp.startup();
+    if (!wasPlaying && timePos.playing) dsp->startup();
     wasPlaying = timePos.playing;
 
     for (size_t i = 0; i < midiEventCount; ++i) handleMidi(midiEvents[i]);
     alreadyRecievedNote.resize(0);
 
-    dsp.setParameters();
-    dsp.process(frames, inputs[0], inputs[1], outputs[0], outputs[1]);
+    dsp->setParameters();
+    dsp->process(frames, inputs[0], inputs[1], outputs[0], outputs[1]);
   }
 
 private:
-  DSPCore dsp;
+  std::unique_ptr<DSPInterface> dsp;
   bool wasPlaying = false;
   uint32_t noteId = 0;
   std::vector<std::pair<uint8_t, uint32_t>> lastNoteId;
@@ -168,7 +168,11 @@ public:
     // FDN.
     const auto leftFDN = leftRandom + 2.0f * knobX + 2.0f * margin;
     addToggleButton(
-      leftFDN, top0, 3.0f * knobX, labelHeight, midTextSize, "FDN", ID::fdn);
+      leftFDN, top0, 2.0f * knobX, labelHeight, midTextSize, "FDN", ID::fdn);
+    std::vector<std::string> fdnMatrixItems{"Random", "Householder"};
+    addOptionMenu(
+      leftFDN + 2.0f * knobX, top0, knobX, labelHeight, uiTextSize, ID::fdnMatrix,
+      fdnMatrixItems);
 
     const auto topFDN = top0 + labelHeight + margin;
     addKnob(leftFDN, topFDN, knobWidth, margin, uiTextSize, "Time", ID::fdnTime);
@@ -186,6 +190,9 @@ public:
 
     const auto topAP = top1 + labelHeight + margin;
     addKnob(leftAP, topAP, knobWidth, margin, uiTextSize, "Mix", ID::allpassMix);
+    addCheckbox(
+      leftAP + 3.5 * margin, topAP + knobHeight + labelHeight + 0.5f * margin,
+      checkboxWidth, labelHeight, uiTextSize, "Sleep", ID::autoSleep);
 
     const auto leftAP1 = leftAP + knobX + 2.0f * margin;
     addGroupLabel(leftAP1, top1, 3.0f * knobX, labelHeight, midTextSize, "Stage 1");
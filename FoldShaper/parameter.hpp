@@ -22,6 +22,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -172,9 +173,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index);
-#endif
 
   void validate()
   {
@@ -20,85 +20,14 @@
 #include <vector>
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/delay.hpp"
 #include "../../common/dsp/smoother.hpp"
 
 namespace SomeDSP {
 
-// 2x oversampled, linear interpolated delay.
-template<typename Sample> class Delay {
-public:
-  Sample sampleRate = 44100.0;
-  Sample rFraction = 0.0;
-  Sample w1 = 0.0;
-  size_t wptr = 0;
-  size_t rptr = 0;
-  std::vector<Sample> buf;
-
-  void setup(double sampleRate, Sample time, Sample maxTime)
-  {
-    this->sampleRate = 2 * sampleRate;
-
-    auto size = size_t(this->sampleRate * maxTime);
-    buf.resize(size >= INT32_MAX ? INT32_MAX : size + 1, 0.0);
-
-    setTime(time);
-    reset();
-  }
-
-  void setTime(Sample seconds)
-  {
-    auto timeInSample
-      = std::max<Sample>(0, std::min<Sample>(sampleRate * seconds, (Sample)buf.size()));
-
-    size_t timeInt = size_t(timeInSample);
-    rFraction = timeInSample - Sample(timeInt);
-
-    // Possible negative overflow. rptr must be in [0, buf.size()).
-    rptr = wptr - timeInt;
-    while (rptr >= buf.size()) rptr += buf.size();
-  }
-
-  Sample getTime()
-  {
-    auto diff = rptr < wptr ? wptr - rptr : wptr + buf.size() - rptr;
-    return diff / sampleRate;
-  }
-
-  void reset()
-  {
-    std::fill(buf.begin(), buf.end(), 0);
-    w1 = 0.0;
-  }
-
-  Sample process(const Sample input)
-  {
-    // Write to buffer.
-    buf[wptr] = input - Sample(0.5) * (input - w1);
-    wptr += 1;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    buf[wptr] = input;
-    wptr += 1;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    w1 = input;
-
-    // Read from buffer.
-    const size_t i1 = rptr;
-    rptr += 1;
-    if (rptr >= buf.size()) rptr -= buf.size();
-
-    const size_t i0 = rptr;
-    rptr += 1;
-    if (rptr >= buf.size()) rptr -= buf.size();
-
-    return buf[i0] - rFraction * (buf[i0] - buf[i1]);
-  }
-};
-
 template<typename Sample> class Chorus {
 public:
-  Delay<Sample> delay;
+  OversampledDelay<Sample> delay;
   Sample phase = 0;
   Sample feedbackBuffer = 0;
   LinearSmoother<Sample> interpTick;
@@ -125,7 +54,7 @@ public:
     Sample delayTimeRange,
     Sample minDelayTime)
   {
-    interpTick.push(Sample(twopi) * frequency / delay.sampleRate);
+    interpTick.push(Sample(twopi) * frequency / delay.getSampleRate());
     interpPhase.push(phase);
     interpFeedback.push(feedback);
     interpDepth.push(depth);
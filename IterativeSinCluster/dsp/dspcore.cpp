@@ -282,41 +282,44 @@ void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 
   std::array<float, 2> frame{};
   std::array<float, 2> chorusOut{};
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    frame.fill(0.0f);
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      frame.fill(0.0f);
 
-    for (auto &note : notes) {
-      if (note.state == NoteState::rest) continue;
-      auto noteSig = note.process();
-      frame[0] += noteSig[0];
-      frame[1] += noteSig[1];
-    }
+      for (auto &note : notes) {
+        if (note.state == NoteState::rest) continue;
+        auto noteSig = note.process();
+        frame[0] += noteSig[0];
+        frame[1] += noteSig[1];
+      }
 
-    if (isTransitioning) {
-      frame[0] += transitionBuffer[mptIndex][0];
-      frame[1] += transitionBuffer[mptIndex][1];
-      transitionBuffer[mptIndex].fill(0.0f);
-      mptIndex = (mptIndex + 1) % transitionBuffer.size();
-      if (mptIndex == mptStop) isTransitioning = false;
-    }
+      if (isTransitioning) {
+        frame[0] += transitionBuffer[mptIndex][0];
+        frame[1] += transitionBuffer[mptIndex][1];
+        transitionBuffer[mptIndex].fill(0.0f);
+        mptIndex = (mptIndex + 1) % transitionBuffer.size();
+        if (mptIndex == mptStop) isTransitioning = false;
+      }
 
-    const auto chorusIn = frame[0] + frame[1];
-    chorusOut.fill(0.0f);
-    for (auto &chrs : chorus) {
-      const auto out = chrs.process(chorusIn);
-      chorusOut[0] += out[0];
-      chorusOut[1] += out[1];
-    }
-    chorusOut[0] /= chorus.size();
-    chorusOut[1] /= chorus.size();
+      const auto chorusIn = frame[0] + frame[1];
+      chorusOut.fill(0.0f);
+      for (auto &chrs : chorus) {
+        const auto out = chrs.process(chorusIn);
+        chorusOut[0] += out[0];
+        chorusOut[1] += out[1];
+      }
+      chorusOut[0] /= chorus.size();
+      chorusOut[1] /= chorus.size();
 
-    const auto chorusMix = interpTremoloMix.process();
-    const auto masterGain = interpMasterGain.process();
-    out0[i] = masterGain * (frame[0] + chorusMix * (chorusOut[0] - frame[0]));
-    out1[i] = masterGain * (frame[1] + chorusMix * (chorusOut[1] - frame[1]));
+      const auto chorusMix = interpTremoloMix.process();
+      const auto masterGain = interpMasterGain.process();
+      out0[i] = masterGain * (frame[0] + chorusMix * (chorusOut[0] - frame[0]));
+      out1[i] = masterGain * (frame[1] + chorusMix * (chorusOut[1] - frame[1]));
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCORE_NAME::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
@@ -102,7 +103,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   virtual void pushMidiNote(
     bool isNoteOn,
@@ -147,23 +148,17 @@ mpt stands for Max Poly Transition. I guess this sounds weird for English native
       note.pitch = pitch;                                                                \
       note.tuning = tuning;                                                              \
       note.velocity = velocity;                                                          \
-      midiNotes.push_back(note);                                                         \
+      midiNotes.push(note);                                                              \
     }                                                                                    \
                                                                                          \
     void processMidiNote(uint32_t frame) override                                        \
     {                                                                                    \
-      while (true) {                                                                     \
-        auto it                                                                          \
-          = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {   \
-              return nt.frame == frame;                                                  \
-            });                                                                          \
-        if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
-          noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
+      midiNotes.dispatch(frame, [&](const MidiNote &nt) {                                \
+        if (nt.isNoteOn)                                                                 \
+          noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);                               \
         else                                                                             \
-          noteOff(it->id);                                                               \
-        midiNotes.erase(it);                                                             \
-      }                                                                                  \
+          noteOff(nt.id);                                                                \
+      });                                                                                \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
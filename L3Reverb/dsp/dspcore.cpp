@@ -43,6 +43,18 @@ void DSPCORE_NAME::setup(double sampleRate)
   reset();
 }
 
+template<size_t nSmoother>
+inline NestParameter<float> getNestParameter(const ExpSmootherArray<nSmoother> &array)
+{
+  using ID = ParameterID::ID;
+
+  const float *data = array.data();
+  return {
+    data + ID::time0,
+    data + ID::innerFeed0,
+    {data + ID::d1Feed0, data + ID::d2Feed0, data + ID::d3Feed0, data + ID::d4Feed0}};
+}
+
 inline std::array<float, 2> calcOffset(float offset, float mul)
 {
   if (offset >= 0) return {mul, (1.0f - offset) * mul};
@@ -50,19 +62,19 @@ inline std::array<float, 2> calcOffset(float offset, float mul)
 }
 
 #define ASSIGN_ALLPASS_PARAMETER(METHOD)                                                 \
-  auto timeMul = param.value[ID::timeMultiply]->getFloat();                              \
-  auto innerMul = param.value[ID::innerFeedMultiply]->getFloat();                        \
-  auto d1FeedMul = param.value[ID::d1FeedMultiply]->getFloat();                          \
-  auto d2FeedMul = param.value[ID::d2FeedMultiply]->getFloat();                          \
-  auto d3FeedMul = param.value[ID::d3FeedMultiply]->getFloat();                          \
-  auto d4FeedMul = param.value[ID::d4FeedMultiply]->getFloat();                          \
+  auto timeMul = snapshot.getFloat(ID::timeMultiply);                                    \
+  auto innerMul = snapshot.getFloat(ID::innerFeedMultiply);                              \
+  auto d1FeedMul = snapshot.getFloat(ID::d1FeedMultiply);                                \
+  auto d2FeedMul = snapshot.getFloat(ID::d2FeedMultiply);                                \
+  auto d3FeedMul = snapshot.getFloat(ID::d3FeedMultiply);                                \
+  auto d4FeedMul = snapshot.getFloat(ID::d4FeedMultiply);                                \
                                                                                          \
-  auto timeOfs = param.value[ID::timeOffsetRange]->getFloat();                           \
-  auto innerOfs = param.value[ID::innerFeedOffsetRange]->getFloat();                     \
-  auto d1FeedOfs = param.value[ID::d1FeedOffsetRange]->getFloat();                       \
-  auto d2FeedOfs = param.value[ID::d2FeedOffsetRange]->getFloat();                       \
-  auto d3FeedOfs = param.value[ID::d3FeedOffsetRange]->getFloat();                       \
-  auto d4FeedOfs = param.value[ID::d4FeedOffsetRange]->getFloat();                       \
+  auto timeOfs = snapshot.getFloat(ID::timeOffsetRange);                                 \
+  auto innerOfs = snapshot.getFloat(ID::innerFeedOffsetRange);                           \
+  auto d1FeedOfs = snapshot.getFloat(ID::d1FeedOffsetRange);                             \
+  auto d2FeedOfs = snapshot.getFloat(ID::d2FeedOffsetRange);                             \
+  auto d3FeedOfs = snapshot.getFloat(ID::d3FeedOffsetRange);                             \
+  auto d4FeedOfs = snapshot.getFloat(ID::d4FeedOffsetRange);                             \
                                                                                          \
   std::uniform_real_distribution<float> timeOffsetDist(-timeOfs, timeOfs);               \
   std::uniform_real_distribution<float> innerOffsetDist(-innerOfs, innerOfs);            \
@@ -76,76 +88,72 @@ inline std::array<float, 2> calcOffset(float offset, float mul)
   uint16_t i3 = 0;                                                                       \
   uint16_t i4 = 0;                                                                       \
                                                                                          \
-  auto &ap4L = delay[0];                                                                 \
-  auto &ap4R = delay[1];                                                                 \
+  auto &prmL = allpassParam[0];                                                          \
+  auto &prmR = allpassParam[1];                                                          \
   for (uint8_t d4 = 0; d4 < nSection4; ++d4) {                                           \
-    auto &ap3L = ap4L.allpass[d4];                                                       \
-    auto &ap3R = ap4R.allpass[d4];                                                       \
     for (uint8_t d3 = 0; d3 < nSection3; ++d3) {                                         \
-      auto &ap2L = ap3L.allpass[d3];                                                     \
-      auto &ap2R = ap3R.allpass[d3];                                                     \
       for (uint8_t d2 = 0; d2 < nSection2; ++d2) {                                       \
-        auto &ap1L = ap2L.allpass[d2];                                                   \
-        auto &ap1R = ap2R.allpass[d2];                                                   \
         for (uint8_t d1 = 0; d1 < nSection1; ++d1) {                                     \
           auto d1TimeOffset = calcOffset(timeOffsetDist(timeRng), timeMul);              \
           auto innerFeedOffset = calcOffset(innerOffsetDist(innerRng), innerMul);        \
           auto d1FeedOffset = calcOffset(d1FeedOffsetDist(d1FeedRng), d1FeedMul);        \
                                                                                          \
-          ap1L.seconds[d1].METHOD(                                                       \
-            param.value[ID::time0 + i1]->getFloat() * d1TimeOffset[0]);                  \
-          ap1L.innerFeed[d1].METHOD(                                                     \
-            param.value[ID::innerFeed0 + i1]->getFloat() * innerFeedOffset[0]);          \
-          ap1L.outerFeed[d1].METHOD(                                                     \
-            param.value[ID::d1Feed0 + i1]->getFloat() * d1FeedOffset[0]);                \
+          auto time = snapshot.getFloat(ID::time0 + i1);                                 \
+          auto innerFeed = snapshot.getFloat(ID::innerFeed0 + i1);                       \
+          auto d1Feed = snapshot.getFloat(ID::d1Feed0 + i1);                             \
+                                                                                         \
+          prmL.METHOD(ID::time0 + i1, time * d1TimeOffset[0]);                           \
+          prmL.METHOD(ID::innerFeed0 + i1, innerFeed * innerFeedOffset[0]);              \
+          prmL.METHOD(ID::d1Feed0 + i1, d1Feed * d1FeedOffset[0]);                       \
                                                                                          \
-          ap1R.seconds[d1].METHOD(                                                       \
-            param.value[ID::time0 + i1]->getFloat() * d1TimeOffset[1]);                  \
-          ap1R.innerFeed[d1].METHOD(                                                     \
-            param.value[ID::innerFeed0 + i1]->getFloat() * innerFeedOffset[1]);          \
-          ap1R.outerFeed[d1].METHOD(                                                     \
-            param.value[ID::d1Feed0 + i1]->getFloat() * d1FeedOffset[1]);                \
+          prmR.METHOD(ID::time0 + i1, time * d1TimeOffset[1]);                           \
+          prmR.METHOD(ID::innerFeed0 + i1, innerFeed * innerFeedOffset[1]);              \
+          prmR.METHOD(ID::d1Feed0 + i1, d1Feed * d1FeedOffset[1]);                       \
                                                                                          \
           ++i1;                                                                          \
         }                                                                                \
                                                                                          \
         auto offsetD2Feed = calcOffset(d2FeedOffsetDist(d2FeedRng), d2FeedMul);          \
-                                                                                         \
-        ap2L.feed[d2].METHOD(                                                            \
-          param.value[ID::d2Feed0 + i2]->getFloat() * offsetD2Feed[0]);                  \
-        ap2R.feed[d2].METHOD(                                                            \
-          param.value[ID::d2Feed0 + i2]->getFloat() * offsetD2Feed[1]);                  \
+        auto d2Feed = snapshot.getFloat(ID::d2Feed0 + i2);                               \
+        prmL.METHOD(ID::d2Feed0 + i2, d2Feed * offsetD2Feed[0]);                         \
+        prmR.METHOD(ID::d2Feed0 + i2, d2Feed * offsetD2Feed[1]);                         \
         ++i2;                                                                            \
       }                                                                                  \
                                                                                          \
       auto offsetD3Feed = calcOffset(d3FeedOffsetDist(d3FeedRng), d3FeedMul);            \
-                                                                                         \
-      ap3L.feed[d3].METHOD(param.value[ID::d3Feed0 + i3]->getFloat() * offsetD3Feed[0]); \
-      ap3R.feed[d3].METHOD(param.value[ID::d3Feed0 + i3]->getFloat() * offsetD3Feed[1]); \
+      auto d3Feed = snapshot.getFloat(ID::d3Feed0 + i3);                                 \
+      prmL.METHOD(ID::d3Feed0 + i3, d3Feed * offsetD3Feed[0]);                           \
+      prmR.METHOD(ID::d3Feed0 + i3, d3Feed * offsetD3Feed[1]);                           \
       ++i3;                                                                              \
     }                                                                                    \
                                                                                          \
     auto offsetD4Feed = calcOffset(d4FeedOffsetDist(d4FeedRng), d4FeedMul);              \
-                                                                                         \
-    ap4L.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[0]);   \
-    ap4R.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[1]);   \
+    auto d4Feed = snapshot.getFloat(ID::d4Feed0 + i4);                                   \
+    prmL.METHOD(ID::d4Feed0 + i4, d4Feed * offsetD4Feed[0]);                             \
+    prmR.METHOD(ID::d4Feed0 + i4, d4Feed * offsetD4Feed[1]);                             \
     ++i4;                                                                                \
-  }                                                                                      \
-                                                                                         \
-  interpStereoCross.METHOD(param.value[ID::stereoCross]->getFloat());                    \
-  interpStereoSpread.METHOD(param.value[ID::stereoSpread]->getFloat());                  \
-  interpDry.METHOD(param.value[ID::dry]->getFloat());                                    \
-  interpWet.METHOD(param.value[ID::wet]->getFloat());
+  }
+
+#define ASSIGN_MIX_PARAMETER(METHOD)                                                     \
+  interpStereoCross.METHOD(snapshot.getFloat(ID::stereoCross));                          \
+  interpStereoSpread.METHOD(snapshot.getFloat(ID::stereoSpread));                        \
+  interpDry.METHOD(snapshot.getFloat(ID::dry));                                          \
+  interpWet.METHOD(snapshot.getFloat(ID::wet));
 
 void DSPCORE_NAME::reset()
 {
   using ID = ParameterID::ID;
 
+  param.snapshot.acquire();
+  const auto &snapshot = param.snapshot;
+
   startup();
 
   for (auto &dly : delay) dly.reset();
+  silence.reset();
 
   ASSIGN_ALLPASS_PARAMETER(reset);
+  ASSIGN_MIX_PARAMETER(reset);
 }
 
 void DSPCORE_NAME::startup()
@@ -164,16 +172,36 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
-  SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  param.snapshot.acquire();
+  const auto &snapshot = param.snapshot;
+
+  SmootherCommon<float>::setTime(snapshot.getFloat(ID::smoothness));
+  silence.setEnabled(snapshot.getInt(ID::autoSleep));
+
+  ASSIGN_MIX_PARAMETER(push);
+
+  // Without modulation, RNGs are reseeded on every call and the allpass targets only
+  // depend on parameters from time0 to seed. Skip the tree when none of them changed.
+  const bool isTimeModulated = snapshot.getInt(ID::timeModulation);
+  const bool isInnerModulated = snapshot.getInt(ID::innerFeedModulation);
+  const bool isD1Modulated = snapshot.getInt(ID::d1FeedModulation);
+  const bool isD2Modulated = snapshot.getInt(ID::d2FeedModulation);
+  const bool isD3Modulated = snapshot.getInt(ID::d3FeedModulation);
+  const bool isD4Modulated = snapshot.getInt(ID::d4FeedModulation);
+  if (
+    !(isTimeModulated || isInnerModulated || isD1Modulated || isD2Modulated
+      || isD3Modulated || isD4Modulated)
+    && !snapshot.isDirty(ID::time0, ID::seed))
+    return;
 
   refreshSeed();
 
-  if (!param.value[ID::timeModulation]->getInt()) timeRng.seed(timeSeed);
-  if (!param.value[ID::innerFeedModulation]->getInt()) innerRng.seed(innerSeed);
-  if (!param.value[ID::d1FeedModulation]->getInt()) d1FeedRng.seed(d1FeedSeed);
-  if (!param.value[ID::d2FeedModulation]->getInt()) d2FeedRng.seed(d2FeedSeed);
-  if (!param.value[ID::d3FeedModulation]->getInt()) d3FeedRng.seed(d3FeedSeed);
-  if (!param.value[ID::d4FeedModulation]->getInt()) d4FeedRng.seed(d4FeedSeed);
+  if (!isTimeModulated) timeRng.seed(timeSeed);
+  if (!isInnerModulated) innerRng.seed(innerSeed);
+  if (!isD1Modulated) d1FeedRng.seed(d1FeedSeed);
+  if (!isD2Modulated) d2FeedRng.seed(d2FeedSeed);
+  if (!isD3Modulated) d3FeedRng.seed(d3FeedSeed);
+  if (!isD4Modulated) d4FeedRng.seed(d4FeedSeed);
 
   ASSIGN_ALLPASS_PARAMETER(push);
 }
@@ -181,31 +209,52 @@ void DSPCORE_NAME::setParameters(float tempo)
 void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
+  if (silence.isSleeping(length, in0, in1)) {
+    std::fill(out0, out0 + length, 0.0f);
+    std::fill(out1, out1 + length, 0.0f);
+    return;
+  }
+
   SmootherCommon<float>::setBufferSize(length);
 
+  const float kp = SmootherCommon<float>::kp;
+  const std::array<NestParameter<float>, 2> nestParam{
+    getNestParameter(allpassParam[0]), getNestParameter(allpassParam[1])};
+
   for (size_t i = 0; i < length; ++i) {
+    allpassParam[0].process(kp);
+    allpassParam[1].process(kp);
+
     const auto cross = interpStereoCross.process();
     const auto delayOut0 = delayOut[0];
     const auto delayOut1 = delayOut[1];
-    delayOut[0] = delay[0].process(in0[i] + cross * delayOut1, sampleRate);
-    delayOut[1] = delay[1].process(in1[i] + cross * delayOut0, sampleRate);
+    delayOut[0] = delay[0].process(in0[i] + cross * delayOut1, sampleRate, nestParam[0]);
+    delayOut[1] = delay[1].process(in1[i] + cross * delayOut0, sampleRate, nestParam[1]);
     const auto mid = delayOut[0] + delayOut[1];
     const auto side = delayOut[0] - delayOut[1];
 
     const auto spread = interpStereoSpread.process();
     delayOut[0] = mid - spread * (mid - side);
     delayOut[1] = mid - spread * (mid + side);
+    silence.track(delayOut[0]);
+    silence.track(delayOut[1]);
 
     const auto dry = interpDry.process();
     const auto wet = interpWet.process();
     out0[i] = dry * in0[i] + wet * delayOut[0];
     out1[i] = dry * in1[i] + wet * delayOut[1];
   }
+
+  // Residue in the network comes out within the time to pass through all allpasses.
+  silence.setHold(
+    sampleRate,
+    2 * std::max(delay[0].pathTime(nestParam[0]), delay[1].pathTime(nestParam[1])));
+  silence.endBlock(length);
 }
 
 void DSPCORE_NAME::refreshSeed()
 {
-  std::minstd_rand rng{param.value[ParameterID::seed]->getInt()};
+  std::minstd_rand rng{param.snapshot.getInt(ParameterID::seed)};
   std::uniform_int_distribution<uint_fast32_t> dist(0, UINT32_MAX);
 
   timeSeed = dist(rng);
@@ -18,16 +18,19 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/nestedallpass.hpp"
+#include "../../common/dsp/silencedetector.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 
-#include "delay.hpp"
-
 #include <array>
 #include <random>
 
 using namespace SomeDSP;
 
+// Smoothed parameters of nested allpasses. Indices are the same as ParameterID.
+constexpr size_t nAllpassParameter = ParameterID::d4Feed0 + nDepth4;
+
 class DSPInterface {
 public:
   virtual ~DSPInterface(){};
@@ -75,8 +78,11 @@ public:
     uint_fast32_t d3FeedSeed = 0;                                                        \
     uint_fast32_t d4FeedSeed = 0;                                                        \
                                                                                          \
-    std::array<NestD4<float, nSection1, nSection2, nSection3, nSection4>, 2> delay;      \
+    std::array<FlatNestedAllpass<float, nSection1, nSection2, nSection3, nSection4>, 2>  \
+      delay;                                                                             \
     std::array<float, 2> delayOut{};                                                     \
+    SilenceDetector silence;                                                             \
+    std::array<ExpSmootherArray<nAllpassParameter>, 2> allpassParam;                     \
     ExpSmoother<float> interpStereoCross;                                                \
     ExpSmoother<float> interpStereoSpread;                                               \
     ExpSmoother<float> interpDry;                                                        \
@@ -18,8 +18,6 @@
 #include "parameter.hpp"
 
 // Generated from preset dump.
-#ifndef TEST_BUILD
-
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -10885,6 +10883,6 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::bypass]->setFromInt(0);
     } break;
   }
-}
 
-#endif
+  updateSnapshot();
+}
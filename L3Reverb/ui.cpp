@@ -325,6 +325,10 @@ public:
     textKnobSeed->sensitivity = 0.001f;
     textKnobSeed->lowSensitivity = 1.0f / Scales::seed.getMax();
 
+    addCheckbox(
+      miscLeft0, miscTop1 + 2 * labelY, textKnobX, labelHeight, uiTextSize, "Sleep",
+      ID::autoSleep);
+
     addKnob(
       miscLeft1 + offsetKnobX, miscTop1, knobX, margin, uiTextSize, "Smooth",
       ID::smoothness);
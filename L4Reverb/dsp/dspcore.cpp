@@ -35,10 +35,14 @@ void DSPCORE_NAME::setup(double sampleRate)
 {
   this->sampleRate = sampleRate;
 
-  SmootherCommon<float>::setSampleRate(sampleRate);
-  SmootherCommon<float>::setTime(0.2f);
+  smootherContext.setSampleRate(sampleRate);
+  smootherContext.setTime(0.2f);
 
   for (auto &dly : delay) dly.setup(sampleRate, Scales::time.getMax());
+  convolver.setup();
+
+  // 10 msec.
+  fadeLength = std::max(size_t(1), size_t(0.01 * sampleRate));
 
   reset();
 }
@@ -49,20 +53,30 @@ inline std::array<float, 2> calcOffset(float offset, float mul)
   return {(1.0f + offset) * mul, mul};
 }
 
+inline NestParameter<float> getNestParameter(const float *data)
+{
+  using ID = ParameterID::ID;
+
+  return {
+    data + ID::time0,
+    data + ID::innerFeed0,
+    {data + ID::d1Feed0, data + ID::d2Feed0, data + ID::d3Feed0, data + ID::d4Feed0}};
+}
+
 #define ASSIGN_ALLPASS_PARAMETER(METHOD)                                                 \
-  auto timeMul = param.value[ID::timeMultiply]->getFloat();                              \
-  auto innerMul = param.value[ID::innerFeedMultiply]->getFloat();                        \
-  auto d1FeedMul = param.value[ID::d1FeedMultiply]->getFloat();                          \
-  auto d2FeedMul = param.value[ID::d2FeedMultiply]->getFloat();                          \
-  auto d3FeedMul = param.value[ID::d3FeedMultiply]->getFloat();                          \
-  auto d4FeedMul = param.value[ID::d4FeedMultiply]->getFloat();                          \
+  auto timeMul = snapshot.getFloat(ID::timeMultiply);                                    \
+  auto innerMul = snapshot.getFloat(ID::innerFeedMultiply);                              \
+  auto d1FeedMul = snapshot.getFloat(ID::d1FeedMultiply);                                \
+  auto d2FeedMul = snapshot.getFloat(ID::d2FeedMultiply);                                \
+  auto d3FeedMul = snapshot.getFloat(ID::d3FeedMultiply);                                \
+  auto d4FeedMul = snapshot.getFloat(ID::d4FeedMultiply);                                \
                                                                                          \
-  auto timeOfs = param.value[ID::timeOffsetRange]->getFloat();                           \
-  auto innerOfs = param.value[ID::innerFeedOffsetRange]->getFloat();                     \
-  auto d1FeedOfs = param.value[ID::d1FeedOffsetRange]->getFloat();                       \
-  auto d2FeedOfs = param.value[ID::d2FeedOffsetRange]->getFloat();                       \
-  auto d3FeedOfs = param.value[ID::d3FeedOffsetRange]->getFloat();                       \
-  auto d4FeedOfs = param.value[ID::d4FeedOffsetRange]->getFloat();                       \
+  auto timeOfs = snapshot.getFloat(ID::timeOffsetRange);                                 \
+  auto innerOfs = snapshot.getFloat(ID::innerFeedOffsetRange);                           \
+  auto d1FeedOfs = snapshot.getFloat(ID::d1FeedOffsetRange);                             \
+  auto d2FeedOfs = snapshot.getFloat(ID::d2FeedOffsetRange);                             \
+  auto d3FeedOfs = snapshot.getFloat(ID::d3FeedOffsetRange);                             \
+  auto d4FeedOfs = snapshot.getFloat(ID::d4FeedOffsetRange);                             \
                                                                                          \
   std::uniform_real_distribution<float> timeOffsetDist(-timeOfs, timeOfs);               \
   std::uniform_real_distribution<float> innerOffsetDist(-innerOfs, innerOfs);            \
@@ -76,76 +90,101 @@ inline std::array<float, 2> calcOffset(float offset, float mul)
   uint16_t i3 = 0;                                                                       \
   uint16_t i4 = 0;                                                                       \
                                                                                          \
-  auto &ap4L = delay[0];                                                                 \
-  auto &ap4R = delay[1];                                                                 \
+  auto &prmL = allpassParam[0];                                                          \
+  auto &prmR = allpassParam[1];                                                          \
   for (uint8_t d4 = 0; d4 < nDepth; ++d4) {                                              \
-    auto &ap3L = ap4L.allpass[d4];                                                       \
-    auto &ap3R = ap4R.allpass[d4];                                                       \
     for (uint8_t d3 = 0; d3 < nDepth; ++d3) {                                            \
-      auto &ap2L = ap3L.allpass[d3];                                                     \
-      auto &ap2R = ap3R.allpass[d3];                                                     \
       for (uint8_t d2 = 0; d2 < nDepth; ++d2) {                                          \
-        auto &ap1L = ap2L.allpass[d2];                                                   \
-        auto &ap1R = ap2R.allpass[d2];                                                   \
         for (uint8_t d1 = 0; d1 < nDepth; ++d1) {                                        \
           auto d1TimeOffset = calcOffset(timeOffsetDist(timeRng), timeMul);              \
           auto innerFeedOffset = calcOffset(innerOffsetDist(innerRng), innerMul);        \
           auto d1FeedOffset = calcOffset(d1FeedOffsetDist(d1FeedRng), d1FeedMul);        \
                                                                                          \
-          ap1L.seconds[d1].METHOD(                                                       \
-            param.value[ID::time0 + i1]->getFloat() * d1TimeOffset[0]);                  \
-          ap1L.innerFeed[d1].METHOD(                                                     \
-            param.value[ID::innerFeed0 + i1]->getFloat() * innerFeedOffset[0]);          \
-          ap1L.outerFeed[d1].METHOD(                                                     \
-            param.value[ID::d1Feed0 + i1]->getFloat() * d1FeedOffset[0]);                \
+          auto time = snapshot.getFloat(ID::time0 + i1);                                 \
+          auto innerFeed = snapshot.getFloat(ID::innerFeed0 + i1);                       \
+          auto d1Feed = snapshot.getFloat(ID::d1Feed0 + i1);                             \
                                                                                          \
-          ap1R.seconds[d1].METHOD(                                                       \
-            param.value[ID::time0 + i1]->getFloat() * d1TimeOffset[1]);                  \
-          ap1R.innerFeed[d1].METHOD(                                                     \
-            param.value[ID::innerFeed0 + i1]->getFloat() * innerFeedOffset[1]);          \
-          ap1R.outerFeed[d1].METHOD(                                                     \
-            param.value[ID::d1Feed0 + i1]->getFloat() * d1FeedOffset[1]);                \
+          prmL.METHOD(ID::time0 + i1, time * d1TimeOffset[0]);                           \
+          prmL.METHOD(ID::innerFeed0 + i1, innerFeed * innerFeedOffset[0]);              \
+          prmL.METHOD(ID::d1Feed0 + i1, d1Feed * d1FeedOffset[0]);                       \
+                                                                                         \
+          prmR.METHOD(ID::time0 + i1, time * d1TimeOffset[1]);                           \
+          prmR.METHOD(ID::innerFeed0 + i1, innerFeed * innerFeedOffset[1]);              \
+          prmR.METHOD(ID::d1Feed0 + i1, d1Feed * d1FeedOffset[1]);                       \
                                                                                          \
           ++i1;                                                                          \
         }                                                                                \
                                                                                          \
         auto offsetD2Feed = calcOffset(d2FeedOffsetDist(d2FeedRng), d2FeedMul);          \
-                                                                                         \
-        ap2L.feed[d2].METHOD(                                                            \
-          param.value[ID::d2Feed0 + i2]->getFloat() * offsetD2Feed[0]);                  \
-        ap2R.feed[d2].METHOD(                                                            \
-          param.value[ID::d2Feed0 + i2]->getFloat() * offsetD2Feed[1]);                  \
+        auto d2Feed = snapshot.getFloat(ID::d2Feed0 + i2);                               \
+        prmL.METHOD(ID::d2Feed0 + i2, d2Feed * offsetD2Feed[0]);                         \
+        prmR.METHOD(ID::d2Feed0 + i2, d2Feed * offsetD2Feed[1]);                         \
         ++i2;                                                                            \
       }                                                                                  \
                                                                                          \
       auto offsetD3Feed = calcOffset(d3FeedOffsetDist(d3FeedRng), d3FeedMul);            \
-                                                                                         \
-      ap3L.feed[d3].METHOD(param.value[ID::d3Feed0 + i3]->getFloat() * offsetD3Feed[0]); \
-      ap3R.feed[d3].METHOD(param.value[ID::d3Feed0 + i3]->getFloat() * offsetD3Feed[1]); \
+      auto d3Feed = snapshot.getFloat(ID::d3Feed0 + i3);                                 \
+      prmL.METHOD(ID::d3Feed0 + i3, d3Feed * offsetD3Feed[0]);                           \
+      prmR.METHOD(ID::d3Feed0 + i3, d3Feed * offsetD3Feed[1]);                           \
       ++i3;                                                                              \
     }                                                                                    \
                                                                                          \
     auto offsetD4Feed = calcOffset(d4FeedOffsetDist(d4FeedRng), d4FeedMul);              \
-                                                                                         \
-    ap4L.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[0]);   \
-    ap4R.feed[d4].METHOD(param.value[ID::d4Feed0 + i4]->getFloat() * offsetD4Feed[1]);   \
+    auto d4Feed = snapshot.getFloat(ID::d4Feed0 + i4);                                   \
+    prmL.METHOD(ID::d4Feed0 + i4, d4Feed * offsetD4Feed[0]);                             \
+    prmR.METHOD(ID::d4Feed0 + i4, d4Feed * offsetD4Feed[1]);                             \
     ++i4;                                                                                \
-  }                                                                                      \
-                                                                                         \
-  interpStereoCross.METHOD(param.value[ID::stereoCross]->getFloat());                    \
-  interpStereoSpread.METHOD(param.value[ID::stereoSpread]->getFloat());                  \
-  interpDry.METHOD(param.value[ID::dry]->getFloat());                                    \
-  interpWet.METHOD(param.value[ID::wet]->getFloat());
+  }
+
+#define ASSIGN_MIX_PARAMETER(METHOD)                                                     \
+  interp.METHOD(Interp::stereoCross, snapshot.getFloat(ID::stereoCross));                \
+  interp.METHOD(Interp::stereoSpread, snapshot.getFloat(ID::stereoSpread));              \
+  interp.METHOD(Interp::dry, snapshot.getFloat(ID::dry));                                \
+  interp.METHOD(Interp::wet, snapshot.getFloat(ID::wet));
+
+// Processes a sample of the stereo delay network. `delayOut` holds the previous output,
+// because cross and spread are in the feedback loop.
+template<typename Delay>
+inline void processNetwork(
+  std::array<Delay, 2> &delay,
+  std::array<float, 2> &delayOut,
+  float in0,
+  float in1,
+  float sampleRate,
+  const std::array<NestParameter<float>, 2> &nestParam,
+  float cross,
+  float spread)
+{
+  delayOut[0] = delay[0].process(in0 + cross * delayOut[1], sampleRate, nestParam[0]);
+  delayOut[1] = delay[1].process(in1 + cross * delayOut[0], sampleRate, nestParam[1]);
+  const auto mid = delayOut[0] + delayOut[1];
+  const auto side = delayOut[0] - delayOut[1];
+
+  delayOut[0] = mid - spread * (mid - side);
+  delayOut[1] = mid - spread * (mid + side);
+}
 
 void DSPCORE_NAME::reset()
 {
   using ID = ParameterID::ID;
 
+  param.snapshot.acquire();
+  const auto &snapshot = param.snapshot;
+
   startup();
 
   for (auto &dly : delay) dly.reset();
+  silence.reset();
+
+  convolver.reset();
+  isConvolving = false;
+  liveTail = 0;
+  convolutionTail = 0;
+  fadeCounter = 0;
+  ++impulseGeneration;
 
   ASSIGN_ALLPASS_PARAMETER(reset);
+  ASSIGN_MIX_PARAMETER(reset);
 }
 
 void DSPCORE_NAME::startup()
@@ -164,46 +203,242 @@ void DSPCORE_NAME::setParameters(float tempo)
 {
   using ID = ParameterID::ID;
 
-  SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  param.snapshot.acquire();
+  const auto &snapshot = param.snapshot;
 
-  refreshSeed();
+  smootherContext.setTime(snapshot.getFloat(ID::smoothness));
+  silence.setEnabled(snapshot.getInt(ID::autoSleep));
+
+  ASSIGN_MIX_PARAMETER(push);
+
+  // Without modulation, RNGs are reseeded on every call and the allpass targets only
+  // depend on parameters from time0 to seed. Skip the tree when none of them changed.
+  const bool isTimeModulated = snapshot.getInt(ID::timeModulation);
+  const bool isInnerModulated = snapshot.getInt(ID::innerFeedModulation);
+  const bool isD1Modulated = snapshot.getInt(ID::d1FeedModulation);
+  const bool isD2Modulated = snapshot.getInt(ID::d2FeedModulation);
+  const bool isD3Modulated = snapshot.getInt(ID::d3FeedModulation);
+  const bool isD4Modulated = snapshot.getInt(ID::d4FeedModulation);
+  const bool isModulated = isTimeModulated || isInnerModulated || isD1Modulated
+    || isD2Modulated || isD3Modulated || isD4Modulated;
+  const bool isAllpassDirty = isModulated || snapshot.isDirty(ID::time0, ID::seed);
+
+  if (isAllpassDirty) {
+    refreshSeed();
+
+    if (!isTimeModulated) timeRng.seed(timeSeed);
+    if (!isInnerModulated) innerRng.seed(innerSeed);
+    if (!isD1Modulated) d1FeedRng.seed(d1FeedSeed);
+    if (!isD2Modulated) d2FeedRng.seed(d2FeedSeed);
+    if (!isD3Modulated) d3FeedRng.seed(d3FeedSeed);
+    if (!isD4Modulated) d4FeedRng.seed(d4FeedSeed);
+
+    ASSIGN_ALLPASS_PARAMETER(push);
+  }
+
+  isConvolutionEnabled = snapshot.getInt(ID::convolution) && !isModulated;
+  if (
+    isAllpassDirty || snapshot.isDirty(ID::stereoCross)
+    || snapshot.isDirty(ID::stereoSpread)) {
+    ++impulseGeneration;
+    stopConvolution();
+  }
+  if (!isConvolutionEnabled) stopConvolution();
+}
+
+/*
+Convolution mode. Without modulation, the delay network is linear and time invariant
+after smoothers are settled. Then its impulse response is captured on `impulseWorker`,
+and StereoConvolver takes over the input.
+
+Switching is an equal-gain crossfade of the input over `fadeLength` samples. Both
+engines have the same response, so their outputs are correlated, and gains summing to 1
+keep the level. Crossfading the input instead of the output keeps the tail of previous
+input. Engine which is switched off keeps running until its tail becomes silent, and
+output is the sum of both engines. `liveTail` and `convolutionTail` count down the
+remaining samples.
 
-  if (!param.value[ID::timeModulation]->getInt()) timeRng.seed(timeSeed);
-  if (!param.value[ID::innerFeedModulation]->getInt()) innerRng.seed(innerSeed);
-  if (!param.value[ID::d1FeedModulation]->getInt()) d1FeedRng.seed(d1FeedSeed);
-  if (!param.value[ID::d2FeedModulation]->getInt()) d2FeedRng.seed(d2FeedSeed);
-  if (!param.value[ID::d3FeedModulation]->getInt()) d3FeedRng.seed(d3FeedSeed);
-  if (!param.value[ID::d4FeedModulation]->getInt()) d4FeedRng.seed(d4FeedSeed);
+`impulse` is only acquired while convolver is silent, because the table is valid until
+next `acquire()`.
+*/
+void DSPCORE_NAME::startConvolution()
+{
+  if (!isConvolutionEnabled || isConvolving || convolutionTail > 0) return;
+  if (
+    !allpassParam[0].isSettled() || !allpassParam[1].isSettled()
+    || !interp.isSettled(Interp::stereoCross) || !interp.isSettled(Interp::stereoSpread))
+    return;
+
+  if (requestedGeneration != impulseGeneration) {
+    ImpulseConfig config;
+    config.generation = impulseGeneration;
+    config.sampleRate = sampleRate;
+    config.stereoCross = interp.getValue(Interp::stereoCross);
+    config.stereoSpread = interp.getValue(Interp::stereoSpread);
+    for (size_t ch = 0; ch < 2; ++ch) {
+      std::copy_n(allpassParam[ch].data(), nAllpassParameter, config.allpass[ch].begin());
+    }
+    impulseWorker.request(config);
+    requestedGeneration = impulseGeneration;
+    return;
+  }
+
+  impulse = impulseWorker.acquire();
+  if (
+    impulse == nullptr || impulse->generation != impulseGeneration
+    || impulse->impulse.length == 0)
+    return;
 
-  ASSIGN_ALLPASS_PARAMETER(push);
+  convolver.restart();
+  isConvolving = true;
+  fadeCounter = fadeLength;
+  liveTail = impulse->impulse.length + fadeLength;
+}
+
+// When a fade to convolver is in progress, it's reversed from the current gain.
+void DSPCORE_NAME::stopConvolution()
+{
+  if (!isConvolving) return;
+  isConvolving = false;
+  liveTail = 0;
+  fadeCounter = fadeLength - fadeCounter;
+  convolutionTail = convolver.flushLength(impulse->impulse) + fadeCounter;
+}
+
+std::shared_ptr<const ImpulseTable>
+DSPCORE_NAME::captureImpulse(const ImpulseConfig &config)
+{
+  auto table = std::make_shared<ImpulseTable>();
+  table->generation = config.generation;
+
+  const std::array<NestParameter<float>, 2> nestParam{
+    getNestParameter(config.allpass[0].data()),
+    getNestParameter(config.allpass[1].data())};
+
+  // Response has ended when output stays under -120 dB for twice the time to pass
+  // through all allpasses, and the state of network is also under -120 dB. Output alone
+  // isn't enough, because one sample delays in nests keep ringing while the output is
+  // quiet. Response can't end before the first arrival, so long path is rejected without
+  // running the network.
+  using Delay = decltype(delay)::value_type;
+  constexpr float threshold = 1e-6f;
+  const float pathTime
+    = std::max(Delay::pathTime(nestParam[0]), Delay::pathTime(nestParam[1]));
+  if (config.sampleRate * pathTime >= StereoConvolver::maxLength) return table;
+  const size_t holdSamples = size_t(2 * config.sampleRate * pathTime) + 1;
+
+  // Same buffer size as `delay`. Shorter buffer changes the read position of the
+  // longest delay.
+  std::array<Delay, 2> network;
+  for (auto &dly : network) dly.setup(config.sampleRate, Scales::time.getMax());
+
+  StereoConvolver::Response response;
+  size_t length = 0;
+  for (size_t ch = 0; ch < 2; ++ch) {
+    for (auto &dly : network) dly.reset();
+
+    auto &rsp0 = response[2 * ch];
+    auto &rsp1 = response[2 * ch + 1];
+    std::array<float, 2> out{};
+    size_t lastLoud = 0;
+    size_t lastCheck = 0;
+    for (size_t n = 0;; ++n) {
+      if (n >= StereoConvolver::maxLength) return table; // Too long to convolve.
+
+      const float input = n == 0 ? 1.0f : 0.0f;
+      processNetwork(
+        network, out, ch == 0 ? input : 0.0f, ch == 0 ? 0.0f : input, config.sampleRate,
+        nestParam, config.stereoCross, config.stereoSpread);
+      rsp0.push_back(out[0]);
+      rsp1.push_back(out[1]);
+      if (std::fabs(out[0]) >= threshold || std::fabs(out[1]) >= threshold) lastLoud = n;
+
+      if (n - lastLoud <= holdSamples || n - lastCheck <= holdSamples) continue;
+      lastCheck = n;
+      const float peak = std::max(
+        network[0].peakState(config.sampleRate, nestParam[0]),
+        network[1].peakState(config.sampleRate, nestParam[1]));
+      if (peak < threshold) break;
+    }
+    length = std::max(length, lastLoud + 1);
+  }
+
+  for (auto &rsp : response) rsp.resize(length, 0.0f);
+  convolver.makeImpulse(table->impulse, response);
+  return table;
 }
 
 void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
-  SmootherCommon<float>::setBufferSize(length);
-
-  for (size_t i = 0; i < length; ++i) {
-    const auto cross = interpStereoCross.process();
-    delayOut[0] = delay[0].process(in0[i] + cross * delayOut[1], sampleRate);
-    delayOut[1] = delay[1].process(in1[i] + cross * delayOut[0], sampleRate);
-    const auto mid = delayOut[0] + delayOut[1];
-    const auto side = delayOut[0] - delayOut[1];
-
-    const auto spread = interpStereoSpread.process();
-    delayOut[0] = mid - spread * (mid - side);
-    delayOut[1] = mid - spread * (mid + side);
-
-    const auto dry = interpDry.process();
-    const auto wet = interpWet.process();
-    out0[i] = dry * in0[i] + wet * delayOut[0];
-    out1[i] = dry * in1[i] + wet * delayOut[1];
+  if (silence.isSleeping(length, in0, in1)) {
+    std::fill(out0, out0 + length, 0.0f);
+    std::fill(out1, out1 + length, 0.0f);
+    return;
   }
+
+  smootherContext.setBufferSize(length);
+
+  startConvolution();
+
+  const float kp = smootherContext.kp;
+  const std::array<NestParameter<float>, 2> nestParam{
+    getNestParameter(allpassParam[0].data()), getNestParameter(allpassParam[1].data())};
+
+  for (size_t i = 0; i < length;) {
+    const size_t blockLength = interp.process(smootherContext, length - i);
+    const float *cross = interp.ramp(Interp::stereoCross);
+    const float *spread = interp.ramp(Interp::stereoSpread);
+    const float *dry = interp.ramp(Interp::dry);
+    const float *wet = interp.ramp(Interp::wet);
+
+    for (size_t j = 0; j < blockLength; ++j, ++i) {
+      float liveGain = isConvolving ? 0.0f : 1.0f;
+      if (fadeCounter > 0) {
+        const float fade = float(fadeCounter) / float(fadeLength);
+        liveGain = isConvolving ? fade : 1.0f - fade;
+        --fadeCounter;
+      }
+      const float convGain = 1.0f - liveGain;
+
+      std::array<float, 2> sig{};
+      if (!isConvolving || liveTail > 0) {
+        allpassParam[0].process(kp);
+        allpassParam[1].process(kp);
+
+        processNetwork(
+          delay, delayOut, liveGain * in0[i], liveGain * in1[i], sampleRate, nestParam,
+          cross[j], spread[j]);
+        if (isConvolving) --liveTail;
+        sig = delayOut;
+      }
+
+      if (isConvolving || convolutionTail > 0) {
+        auto conv
+          = convolver.process(convGain * in0[i], convGain * in1[i], impulse->impulse);
+        sig[0] += conv[0];
+        sig[1] += conv[1];
+        if (!isConvolving) --convolutionTail;
+      }
+
+      silence.track(sig[0]);
+      silence.track(sig[1]);
+
+      out0[i] = dry[j] * in0[i] + wet[j] * sig[0];
+      out1[i] = dry[j] * in1[i] + wet[j] * sig[1];
+    }
+  }
+
+  // Residue in the network comes out within the time to pass through all allpasses.
+  silence.setHold(
+    sampleRate,
+    2 * std::max(delay[0].pathTime(nestParam[0]), delay[1].pathTime(nestParam[1])));
+  silence.endBlock(length);
 }
 
 void DSPCORE_NAME::refreshSeed()
 {
-  std::minstd_rand rng{param.value[ParameterID::seed]->getInt()};
+  std::minstd_rand rng{param.snapshot.getInt(ParameterID::seed)};
   std::uniform_int_distribution<uint_fast32_t> dist(0, UINT32_MAX);
 
   timeSeed = dist(rng);
@@ -18,16 +18,49 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/nestedallpass.hpp"
+#include "../../common/dsp/convolver.hpp"
+#include "../../common/dsp/silencedetector.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/dsp/tableworker.hpp"
 #include "../parameter.hpp"
 
-#include "delay.hpp"
-
 #include <array>
+#include <memory>
 #include <random>
 
 using namespace SomeDSP;
 
+// Smoothed parameters of nested allpasses. Indices are the same as ParameterID.
+constexpr size_t nAllpassParameter = ParameterID::d4Feed0 + nDepth4;
+
+namespace Interp {
+enum ID : size_t { stereoCross, stereoSpread, dry, wet, ID_ENUM_LENGTH };
+} // namespace Interp
+
+// Settled parameters of nested allpasses. Cross and spread are also included, because
+// they are in the feedback loop. `generation` tells which parameters the impulse response
+// belongs to.
+struct ImpulseConfig {
+  uint32_t generation = 0;
+  float sampleRate = 44100.0f;
+  float stereoCross = 0.0f;
+  float stereoSpread = 0.0f;
+  std::array<std::array<float, nAllpassParameter>, 2> allpass{};
+
+  bool operator==(const ImpulseConfig &rhs) const
+  {
+    return generation == rhs.generation && sampleRate == rhs.sampleRate
+      && stereoCross == rhs.stereoCross && stereoSpread == rhs.stereoSpread
+      && allpass == rhs.allpass;
+  }
+};
+
+struct ImpulseTable {
+  uint32_t generation = 0;
+  StereoConvolver::Impulse impulse; // `length` is 0 when the response is too long.
+};
+
 class DSPInterface {
 public:
   virtual ~DSPInterface(){};
@@ -59,6 +92,9 @@ public:
                                                                                          \
   private:                                                                               \
     void refreshSeed();                                                                  \
+    void startConvolution();                                                             \
+    void stopConvolution();                                                              \
+    std::shared_ptr<const ImpulseTable> captureImpulse(const ImpulseConfig &config);     \
                                                                                          \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
@@ -75,12 +111,26 @@ public:
     uint_fast32_t d3FeedSeed = 0;                                                        \
     uint_fast32_t d4FeedSeed = 0;                                                        \
                                                                                          \
-    std::array<NestD4<float, 4>, 2> delay;                                               \
+    std::array<FlatNestedAllpass<float, 4, 4, 4, 4>, 2> delay;                           \
     std::array<float, 2> delayOut{};                                                     \
-    ExpSmoother<float> interpStereoCross;                                                \
-    ExpSmoother<float> interpStereoSpread;                                               \
-    ExpSmoother<float> interpDry;                                                        \
-    ExpSmoother<float> interpWet;                                                        \
+    SilenceDetector silence;                                                             \
+    SmootherContext smootherContext;                                                     \
+    std::array<ExpSmootherArray<nAllpassParameter>, 2> allpassParam;                     \
+    ExpSmootherBank<Interp::ID_ENUM_LENGTH> interp;                                      \
+                                                                                         \
+    /* Convolution mode. See comment on `startConvolution`. */                           \
+    bool isConvolutionEnabled = false;                                                   \
+    bool isConvolving = false;                                                           \
+    size_t liveTail = 0;        /* Samples to drain delay while convolving. */           \
+    size_t convolutionTail = 0; /* Samples to flush convolver after stop. */             \
+    size_t fadeLength = 1;                                                               \
+    size_t fadeCounter = 0; /* Remaining samples of input crossfade. */                  \
+    uint32_t impulseGeneration = 0;                                                      \
+    uint32_t requestedGeneration = 0;                                                    \
+    const ImpulseTable *impulse = nullptr;                                               \
+    StereoConvolver convolver;                                                           \
+    TableWorker<ImpulseTable, ImpulseConfig> impulseWorker{                              \
+      [this](const ImpulseConfig &config) { return captureImpulse(config); }};           \
   };
 
 DSPCORE_CLASS(AVX512)
@@ -18,8 +18,10 @@
 #pragma once
 
 #include "../common/parameterinterface.hpp"
+#include "../common/parametersnapshot.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -77,6 +79,8 @@ enum ID {
 
   smoothness,
   bypass,
+  convolution,
+  autoSleep,
 
   ID_ENUM_LENGTH,
 };
@@ -97,6 +101,7 @@ struct Scales {
 
 struct GlobalParameter : public ParameterInterface {
   std::vector<std::unique_ptr<ValueInterface>> value;
+  ParameterSnapshot<ParameterID::ID_ENUM_LENGTH> snapshot; // Read by DSP.
 
   GlobalParameter()
   {
@@ -199,6 +204,12 @@ struct GlobalParameter : public ParameterInterface {
       0.5, Scales::smoothness, "smoothness", kParameterIsAutomable);
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
+    value[ID::convolution] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "convolution", kParameterIsAutomable | kParameterIsBoolean);
+    value[ID::autoSleep] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "autoSleep", kParameterIsAutomable | kParameterIsBoolean);
+
+    updateSnapshot();
   }
 
 #ifndef TEST_BUILD
@@ -214,6 +225,21 @@ struct GlobalParameter : public ParameterInterface {
   void resetParameter()
   {
     for (auto &val : value) val->setFromNormalized(val->getDefaultNormalized());
+    updateSnapshot();
+  }
+
+  // Publishes `value` to `snapshot`. Call this after writing to `value` directly.
+  void updateSnapshot()
+  {
+    for (size_t idx = 0; idx < value.size(); ++idx)
+      snapshot.set(idx, float(value[idx]->getFloat()));
+    snapshot.publish();
+  }
+
+  void updateSnapshot(uint32_t index)
+  {
+    snapshot.set(index, float(value[index]->getFloat()));
+    snapshot.publish();
   }
 
   double getNormalized(uint32_t index) const override
@@ -244,12 +270,14 @@ struct GlobalParameter : public ParameterInterface {
   {
     if (index >= value.size()) return;
     value[index]->setFromFloat(raw);
+    updateSnapshot(index);
   }
 
   double parameterChanged(uint32_t index, float raw) override
   {
     if (index >= value.size()) return 0.0;
     value[index]->setFromFloat(raw);
+    updateSnapshot(index);
     return value[index]->getNormalized();
   }
 
@@ -257,6 +285,7 @@ struct GlobalParameter : public ParameterInterface {
   {
     if (index >= value.size()) return 0.0;
     value[index]->setFromNormalized(normalized);
+    updateSnapshot(index);
     return value[index]->getFloat();
   }
 
@@ -308,9 +337,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 
   void validate()
   {
@@ -18,8 +18,6 @@
 #include "parameter.hpp"
 
 // Generated from preset dump.
-#ifndef TEST_BUILD
-
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -907,6 +905,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetAbility: {
@@ -1787,6 +1786,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.37200015783309937);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetAdaptability: {
@@ -2667,6 +2667,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.40800002217292786);
       value[ID::smoothness]->setFromNormalized(0.26800021529197693);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetAptness: {
@@ -3547,6 +3548,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.27200013399124146);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetCapability: {
@@ -4427,6 +4429,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.7480001449584961);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetColdHardReverb: {
@@ -5307,6 +5310,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetCompetency: {
@@ -6187,6 +6191,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetCost: {
@@ -7067,6 +7072,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.7240000367164612);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetCreativity: {
@@ -7947,6 +7953,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetEfficiency: {
@@ -8827,6 +8834,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetExpertise: {
@@ -9707,6 +9715,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetLatePeak: {
@@ -10587,6 +10596,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetLiability: {
@@ -11467,6 +11477,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(1.0);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetMerit: {
@@ -12347,6 +12358,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.6800003051757812);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetNarrowTube: {
@@ -13227,6 +13239,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetPotential: {
@@ -14107,6 +14120,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.568000078201294);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetProductivity: {
@@ -14987,6 +15001,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetProficiency: {
@@ -15867,6 +15882,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.9159998893737793);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetProfitability: {
@@ -16747,6 +16763,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.296000212430954);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetResonance: {
@@ -17627,6 +17644,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetResponsibility: {
@@ -18507,6 +18525,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.2279999554157257);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetSkill: {
@@ -19387,6 +19406,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetSusceptibility: {
@@ -20267,6 +20287,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.7480001449584961);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetSustainability: {
@@ -21147,6 +21168,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5439997315406799);
       value[ID::smoothness]->setFromNormalized(0.6040000915527344);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetTalent: {
@@ -22027,6 +22049,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.7480001449584961);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetTinCan: {
@@ -22907,6 +22930,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetViability: {
@@ -23787,6 +23811,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.7240001559257507);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetWobblyShort: {
@@ -24667,6 +24692,7 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
 
     case presetYamabiko: {
@@ -25547,8 +25573,9 @@ void GlobalParameter::loadProgram(uint32_t index)
       value[ID::wet]->setFromNormalized(0.5);
       value[ID::smoothness]->setFromNormalized(0.5);
       value[ID::bypass]->setFromInt(0);
+      value[ID::convolution]->setFromInt(0);
     } break;
   }
-}
 
-#endif
+  updateSnapshot();
+}
@@ -17,77 +17,14 @@
 
 #pragma once
 
-#include <algorithm>
 #include <array>
-#include <climits>
-#include <vector>
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/delay.hpp"
 #include "../../common/dsp/smoother.hpp"
 
 namespace SomeDSP {
 
-// 2x oversampled delay.
-template<typename Sample> class Delay {
-public:
-  Sample w1 = 0;
-  Sample rFraction = 0.0;
-  int wptr = 0;
-  int rptr = 0;
-  int size = 0;
-  std::vector<Sample> buf;
-
-  void setup(Sample sampleRate, Sample maxTime)
-  {
-    size = int(Sample(2) * sampleRate * maxTime) + 1;
-    if (size < 4) size = 4;
-
-    buf.resize(size);
-
-    reset();
-  }
-
-  void reset()
-  {
-    w1 = 0;
-    std::fill(buf.begin(), buf.end(), 0);
-  }
-
-  Sample process(Sample input, Sample sampleRate, Sample seconds)
-  {
-    // Set delay time.
-    Sample timeInSample = std::clamp<Sample>(Sample(2) * sampleRate * seconds, 0, size);
-
-    int timeInt = int(timeInSample);
-    rFraction = timeInSample - Sample(timeInt);
-
-    rptr = wptr - timeInt;
-    if (rptr < 0) rptr += size;
-
-    // Write to buffer.
-    buf[wptr] = Sample(0.5) * (input + w1);
-    ++wptr;
-    if (wptr >= size) wptr -= size;
-
-    buf[wptr] = input;
-    ++wptr;
-    if (wptr >= size) wptr -= size;
-
-    w1 = input;
-
-    // Read from buffer.
-    const size_t i1 = rptr;
-    ++rptr;
-    if (rptr >= size) rptr -= size;
-
-    const size_t i0 = rptr;
-    ++rptr;
-    if (rptr >= size) rptr -= size;
-
-    return buf[i0] - rFraction * (buf[i0] - buf[i1]);
-  }
-};
-
 /**
 Allpass filter with arbitrary length delay.
 https://ccrma.stanford.edu/~jos/pasp/Allpass_Two_Combs.html
@@ -95,9 +32,9 @@ https://ccrma.stanford.edu/~jos/pasp/Allpass_Two_Combs.html
 template<typename Sample> class LongAllpass {
 public:
   Sample buffer = 0;
-  Delay<Sample> delay;
+  OversampledDelay<Sample, AverageMidpoint> delay;
 
-  void setup(Sample sampleRate, Sample maxTime) { delay.setup(sampleRate, maxTime); }
+  void setup(Sample sampleRate, Sample maxTime) { delay.setup(sampleRate, 0, maxTime); }
 
   void reset()
   {
@@ -106,11 +43,12 @@ public:
   }
 
   // gain in [0, 1].
-  Sample process(Sample input, Sample sampleRate, Sample seconds, Sample gain)
+  Sample process(Sample input, Sample seconds, Sample gain)
   {
     input -= gain * buffer;
     auto output = buffer + gain * input;
-    buffer = delay.process(input, sampleRate, seconds);
+    delay.setTime(seconds);
+    buffer = delay.process(input);
     return output;
   }
 };
@@ -144,7 +82,7 @@ public:
     for (auto &lp : lowpass) lp.reset();
   }
 
-  Sample process(Sample input, Sample sampleRate)
+  Sample process(Sample input)
   {
     for (size_t idx = 0; idx < nest; ++idx) {
       input -= data[idx].outerFeed * buffer[idx];
@@ -153,8 +91,7 @@ public:
 
     Sample out = in.back();
     for (size_t idx = nest - 1; idx < nest; --idx) {
-      auto apOut
-        = allpass[idx].process(out, sampleRate, data[idx].seconds, data[idx].innerFeed);
+      auto apOut = allpass[idx].process(out, data[idx].seconds, data[idx].innerFeed);
       out = buffer[idx] + data[idx].outerFeed * in[idx];
 
       lowpass[idx].kp = data[idx].lowpassKp;
@@ -182,8 +119,7 @@ public:
     apR.reset();
   }
 
-  std::array<Sample, 2>
-  process(Sample inL, Sample inR, Sample sampleRate, Sample stereoCross = 0.2)
+  std::array<Sample, 2> process(Sample inL, Sample inR, Sample stereoCross = 0.2)
   {
     for (size_t idx = 0; idx < nest; idx += 2) {
       Sample tmpL = apL.buffer[idx];
@@ -191,7 +127,7 @@ public:
       apR.buffer[idx] -= stereoCross * (tmpL + apR.buffer[idx]);
     }
 
-    return {apL.process(inL, sampleRate), apR.process(inR, sampleRate)};
+    return {apL.process(inL), apR.process(inR)};
   }
 };
 
@@ -52,6 +52,7 @@ void DSPCORE_NAME::reset()
   using ID = ParameterID::ID;
 
   delay.reset();
+  silence.reset();
 
   auto timeMul = param.value[ID::timeMultiply]->getFloat();
   auto outerMul = param.value[ID::outerFeedMultiply]->getFloat();
@@ -98,6 +99,7 @@ void DSPCORE_NAME::setParameters(float tempo)
   using ID = ParameterID::ID;
 
   SmootherCommon<float>::setTime(param.value[ID::smoothness]->getFloat());
+  silence.setEnabled(param.value[ID::autoSleep]->getInt());
 
   auto timeMul = param.value[ID::timeMultiply]->getFloat();
   auto outerMul = param.value[ID::outerFeedMultiply]->getFloat();
@@ -147,6 +149,12 @@ void DSPCORE_NAME::setParameters(float tempo)
 void DSPCORE_NAME::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
+  if (silence.isSleeping(length, in0, in1)) {
+    std::fill(out0, out0 + length, 0.0f);
+    std::fill(out1, out1 + length, 0.0f);
+    return;
+  }
+
   SmootherCommon<float>::setBufferSize(length);
 
   for (size_t i = 0; i < length; ++i) {
@@ -164,8 +172,9 @@ void DSPCORE_NAME::process(
       delay.apR.data[idx].lowpassKp = lpCut;
     }
 
-    auto delayOut
-      = delay.process(in0[i], in1[i], sampleRate, interpStereoCross.process());
+    auto delayOut = delay.process(in0[i], in1[i], interpStereoCross.process());
+    silence.track(delayOut[0]);
+    silence.track(delayOut[1]);
     const auto mid = delayOut[0] + delayOut[1];
     const auto side = delayOut[0] - delayOut[1];
 
@@ -178,4 +187,14 @@ void DSPCORE_NAME::process(
     out0[i] = dry * in0[i] + wet * delayOut[0];
     out1[i] = dry * in1[i] + wet * delayOut[1];
   }
+
+  // Allpasses are in series. Residue comes out within the sum of their delay times.
+  float timeL = 0;
+  float timeR = 0;
+  for (size_t idx = 0; idx < nestingDepth; ++idx) {
+    timeL += delay.apL.data[idx].seconds;
+    timeR += delay.apR.data[idx].seconds;
+  }
+  silence.setHold(sampleRate, 2 * std::max(timeL, timeR));
+  silence.endBlock(length);
 }
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/silencedetector.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 
@@ -65,6 +66,7 @@ public:
     std::array<std::array<PController<float>, nestingDepth>, 2> lowpassLfoTime;          \
                                                                                          \
     StereoLongAllpass<float, nestingDepth> delay;                                        \
+    SilenceDetector silence;                                                             \
     std::array<std::array<ExpSmoother<float>, nestingDepth>, 2> interpTime;              \
     std::array<std::array<ExpSmoother<float>, nestingDepth>, 2> interpOuterFeed;         \
     std::array<std::array<ExpSmoother<float>, nestingDepth>, 2> interpInnerFeed;         \
@@ -20,6 +20,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -64,6 +65,7 @@ enum ID {
 
   smoothness,
   bypass,
+  autoSleep,
 
   ID_ENUM_LENGTH,
 };
@@ -166,6 +168,8 @@ struct GlobalParameter : public ParameterInterface {
       0.5, Scales::smoothness, "smoothness", kParameterIsAutomable);
     value[ID::bypass] = std::make_unique<IntValue>(
       0, Scales::boolScale, "bypass", kParameterIsAutomable | kParameterIsBoolean);
+    value[ID::autoSleep] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "autoSleep", kParameterIsAutomable | kParameterIsBoolean);
   }
 
 #ifndef TEST_BUILD
@@ -279,9 +283,9 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index);
-#endif
 
   void validate()
   {
@@ -18,8 +18,6 @@
 #include "parameter.hpp"
 
 // Generated from preset dump.
-#ifndef TEST_BUILD
-
 void GlobalParameter::loadProgram(uint32_t index)
 {
   using ID = ParameterID::ID;
@@ -2910,5 +2908,3 @@ void GlobalParameter::loadProgram(uint32_t index)
     } break;
   }
 }
-
-#endif
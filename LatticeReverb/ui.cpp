@@ -243,6 +243,9 @@ public:
     addKnob(
       leftSmooth, miscTop1 + knobY + labelY, knobX, margin, uiTextSize, "Smooth",
       ID::smoothness);
+    addCheckbox(
+      left0, miscTop1 + knobY + labelY + 0.5f * labelHeight, textKnobX, labelHeight,
+      uiTextSize, "Sleep", ID::autoSleep);
 
     // Right side.
     const auto tabViewLeft = left0 + leftPanelWidth + labelY;
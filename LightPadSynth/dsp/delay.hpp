@@ -17,79 +17,35 @@
 
 #pragma once
 
-#include <algorithm>
-#include <climits>
-#include <vector>
-
-#include "../../common/dsp/constants.hpp"
-#include "../../common/dsp/smoother.hpp"
+#include "../../common/dsp/delay.hpp"
 
 namespace SomeDSP {
 
 // 2x oversampled delay with feedback.
 template<typename Sample> class Delay {
 public:
-  Sample w1 = 0;
-  Sample r1 = 0;
-  Sample rFraction = 0.0;
-  int wptr = 0;
-  int rptr = 0;
-  std::vector<Sample> buf;
-
   void setup(Sample sampleRate, Sample time, Sample maxTime)
   {
-    auto size = int(Sample(2) * sampleRate * maxTime) + 1;
-    buf.resize(size < 0 ? 4 : size);
-
-    setTime(sampleRate, time);
-    reset();
+    delay.setup(sampleRate, time, maxTime);
+    r1 = 0;
   }
 
   void reset()
   {
-    std::fill(buf.begin(), buf.end(), 0);
-    w1 = 0;
+    delay.reset();
     r1 = 0;
   }
 
-  void setTime(Sample sampleRate, Sample seconds)
-  {
-    Sample timeInSample
-      = std::clamp<Sample>(Sample(2) * sampleRate * seconds, 0, buf.size());
-
-    int timeInt = int(timeInSample);
-    rFraction = timeInSample - Sample(timeInt);
-
-    rptr = wptr - timeInt;
-    if (rptr < 0) rptr += buf.size();
-  }
+  void setTime(Sample seconds) { delay.setTime(seconds); }
 
   Sample process(Sample input, Sample feedback)
   {
-    input += feedback * r1;
-
-    // Write to buffer.
-    buf[wptr] = input - Sample(0.5) * (input - w1);
-    ++wptr;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    buf[wptr] = input;
-    ++wptr;
-    if (wptr >= buf.size()) wptr -= buf.size();
-
-    w1 = input;
-
-    // Read from buffer.
-    const size_t i1 = rptr;
-    ++rptr;
-    if (rptr >= buf.size()) rptr -= buf.size();
-
-    const size_t i0 = rptr;
-    ++rptr;
-    if (rptr >= buf.size()) rptr -= buf.size();
-
-    return r1 = buf[i0] - rFraction * (buf[i0] - buf[i1]);
+    return r1 = delay.process(input + feedback * r1);
   }
+
+private:
+  Sample r1 = 0;
+  OversampledDelay<Sample> delay;
 };
 
 } // namespace SomeDSP
@@ -81,7 +81,7 @@ void NOTE_NAME::noteOn(
   float pan,
   float phase,
   float sampleRate,
-  Wavetable &wavetable,
+  const Wavetable &wavetable,
   NoteProcessInfo &info,
   GlobalParameter &param)
 {
@@ -127,6 +127,11 @@ void NOTE_NAME::noteOn(
   delayGate.reset(sampleRate, param.value[ID::delayAttack]->getFloat(), noteFreq);
 }
 
+void NOTE_NAME::changeTable(const Wavetable &from, const Wavetable &to)
+{
+  osc.changeTable(noteFreq, to.tableBaseFreq, from.tableSize, to.tableSize);
+}
+
 void NOTE_NAME::release()
 {
   if (state == NoteState::rest) return;
@@ -142,7 +147,7 @@ bool NOTE_NAME::isAttacking() { return gainEnvelope.isAttacking(); }
 float NOTE_NAME::getGain() { return gain; }
 
 std::array<float, 2>
-NOTE_NAME::process(float sampleRate, Wavetable &wavetable, NoteProcessInfo &info)
+NOTE_NAME::process(float sampleRate, const Wavetable &wavetable, NoteProcessInfo &info)
 {
   gain = velocity * gainEnvelope.process();
   if (gainEnvelope.isTerminated()) state = NoteState::rest;
@@ -157,7 +162,7 @@ NOTE_NAME::process(float sampleRate, Wavetable &wavetable, NoteProcessInfo &info
   const auto filterOut
     = filter.process(oscOut, sampleRate, cutoff, info.filterResonance.getValue());
 
-  delay.setTime(sampleRate, delaySeconds * info.delayDetune.getValue() * info.lfoOut);
+  delay.setTime(delaySeconds * info.delayDetune.getValue() * info.lfoOut);
   const auto delayOut
     = delay.process(delayGate.process() * filterOut, info.delayFeedback.getValue());
 
@@ -174,7 +179,8 @@ DSPCORE_NAME::DSPCORE_NAME()
   noteIndices.reserve(maxVoice);
   voiceIndices.reserve(maxVoice);
 
-  peakInfos.resize(nOvertone);
+  silentTable.resize(1);
+  wavetable = &silentTable;
 }
 
 void DSPCORE_NAME::setup(double sampleRate)
@@ -258,8 +264,11 @@ void DSPCORE_NAME::setParameters(float tempo)
     refreshLfo();
   isLFORefreshed = param.value[ID::refreshLFO]->getInt();
 
-  if (prepareRefresh || (!isTableRefeshed && param.value[ID::refreshTable]->getInt()))
+  // Sounds stop on request, in the same way as when the table was built here.
+  if (prepareRefresh || (!isTableRefeshed && param.value[ID::refreshTable]->getInt())) {
+    reset();
     refreshTable();
+  }
   isTableRefeshed = param.value[ID::refreshTable]->getInt();
 
   prepareRefresh = false;
@@ -267,35 +276,49 @@ void DSPCORE_NAME::setParameters(float tempo)
 
 void DSPCORE_NAME::process(const size_t length, float *out0, float *out1)
 {
+  // Table is swapped only here. Until the first table is built, notes start on a silent
+  // table, so note events, envelopes and random numbers advance as usual. Notes which
+  // started after the request are carried over to the new table.
+  const Wavetable *front = tableWorker.acquire();
+  if (front == nullptr) front = &silentTable;
+  if (front != wavetable) {
+    for (auto &note : notes)
+      if (note.state != NoteState::rest) note.changeTable(*wavetable, *front);
+    wavetable = front;
+  }
+
   SmootherCommon<float>::setBufferSize(length);
 
   std::array<float, 2> frame{};
-  for (uint32_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    info.process(sampleRate, lfoWavetable);
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      info.process(sampleRate, lfoWavetable);
 
-    frame.fill(0.0f);
+      frame.fill(0.0f);
 
-    for (auto &note : notes) {
-      if (note.state == NoteState::rest) continue;
-      auto sig = note.process(sampleRate, wavetable, info);
-      frame[0] += sig[0];
-      frame[1] += sig[1];
-    }
+      for (auto &note : notes) {
+        if (note.state == NoteState::rest) continue;
+        auto sig = note.process(sampleRate, *wavetable, info);
+        frame[0] += sig[0];
+        frame[1] += sig[1];
+      }
 
-    if (isTransitioning) {
-      frame[0] += transitionBuffer[trIndex][0];
-      frame[1] += transitionBuffer[trIndex][1];
-      transitionBuffer[trIndex].fill(0.0f);
-      trIndex = (trIndex + 1) % transitionBuffer.size();
-      if (trIndex == trStop) isTransitioning = false;
-    }
+      if (isTransitioning) {
+        frame[0] += transitionBuffer[trIndex][0];
+        frame[1] += transitionBuffer[trIndex][1];
+        transitionBuffer[trIndex].fill(0.0f);
+        trIndex = (trIndex + 1) % transitionBuffer.size();
+        if (trIndex == trStop) isTransitioning = false;
+      }
 
-    const auto masterGain = interpMasterGain.process();
-    out0[i] = masterGain * frame[0];
-    out1[i] = masterGain * frame[1];
+      const auto masterGain = interpMasterGain.process();
+      out0[i] = masterGain * frame[0];
+      out1[i] = masterGain * frame[1];
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCORE_NAME::setUnisonPan(size_t nUnison)
@@ -441,7 +464,7 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
 
   if (nUnison <= 1) {
     notes[noteIndices[0]].noteOn(
-      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, sampleRate, wavetable,
+      identifier, float(pitch) + tuning, velocity, 0.5f, 0.0f, sampleRate, *wavetable,
       info, param);
     return;
   }
@@ -461,7 +484,7 @@ void DSPCORE_NAME::noteOn(int32_t identifier, int16_t pitch, float tuning, float
     auto phase = unisonPhase * unison / float(nUnison);
     notes[noteIndices[unison]].noteOn(
       identifier, notePitch, distGain(info.rng) * velocity, unisonPan[unison], phase,
-      sampleRate, wavetable, info, param);
+      sampleRate, *wavetable, info, param);
   }
 }
 
@@ -482,7 +505,7 @@ void DSPCORE_NAME::fillTransitionBuffer(size_t noteIndex)
       break;
     }
 
-    auto oscOut = note.process(sampleRate, wavetable, info);
+    auto oscOut = note.process(sampleRate, *wavetable, info);
     auto idx = (trIndex + bufIdx) % transitionBuffer.size();
     auto interp = 1.0f - float(bufIdx) / transitionBuffer.size();
 
@@ -501,14 +524,15 @@ void DSPCORE_NAME::refreshTable()
 {
   using ID = ParameterID::ID;
 
-  reset();
-
   const float tableBaseFreq = param.value[ID::tableBaseFrequency]->getFloat();
   const float pitchMultiplier = param.value[ID::overtonePitchMultiply]->getFloat();
   const float pitchModulo = param.value[ID::overtonePitchModulo]->getFloat();
   const float gainPow = param.value[ID::overtoneGainPower]->getFloat();
   const float widthMul = param.value[ID::overtoneWidthMultiply]->getFloat();
 
+  PadSynthConfig config;
+  auto &peakInfos = config.peakInfos;
+  peakInfos.resize(nOvertone);
   for (size_t idx = 0; idx < peakInfos.size(); ++idx) {
     peakInfos[idx].frequency = (pitchMultiplier * idx + 1.0f) * tableBaseFreq
       * param.value[ID::overtonePitch0 + idx]->getFloat();
@@ -525,14 +549,20 @@ void DSPCORE_NAME::refreshTable()
 
   size_t bufferSize = param.value[ID::tableBufferSize]->getInt();
   if (bufferSize >= 12) bufferSize = 11;
-  wavetable.resize(1024 << bufferSize);
-
-  wavetable.padsynth(
-    sampleRate, tableBaseFreq, peakInfos, param.value[ID::padSynthSeed]->getInt(),
-    param.value[ID::spectrumExpand]->getFloat(),
-    param.value[ID::spectrumRotate]->getFloat(),
-    param.value[ID::profileComb]->getInt() + 1, param.value[ID::profileShape]->getFloat(),
-    param.value[ID::uniformPhaseProfile]->getInt());
+
+  config.sampleRate = sampleRate;
+  config.tableBaseFreq = tableBaseFreq;
+  config.tableSize = 1024 << bufferSize;
+  config.seed = param.value[ID::padSynthSeed]->getInt();
+  config.expand = param.value[ID::spectrumExpand]->getFloat();
+  config.rotate = param.value[ID::spectrumRotate]->getFloat();
+  config.profileSkip = param.value[ID::profileComb]->getInt() + 1;
+  config.profileShape = param.value[ID::profileShape]->getFloat();
+  config.uniformPhaseProfile = param.value[ID::uniformPhaseProfile]->getInt();
+
+  // Instances with same config share one table. It may be built, or loaded from disk
+  // cache, so the worker does it off the audio thread.
+  tableWorker.request(config);
 }
 
 void DSPCORE_NAME::refreshLfo()
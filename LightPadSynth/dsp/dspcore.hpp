@@ -18,7 +18,10 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
+#include "../../common/dsp/tablecache.hpp"
+#include "../../common/dsp/tableworker.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
 #include "envelope.hpp"
@@ -127,16 +130,17 @@ struct NoteProcessInfo {
       float pan,                                                                         \
       float phase,                                                                       \
       float sampleRate,                                                                  \
-      Wavetable &wavetable,                                                              \
+      const Wavetable &wavetable,                                                        \
       NoteProcessInfo &info,                                                             \
       GlobalParameter &param);                                                           \
+    void changeTable(const Wavetable &from, const Wavetable &to);                        \
     void release();                                                                      \
     void release(float seconds);                                                         \
     void rest();                                                                         \
     bool isAttacking();                                                                  \
     float getGain();                                                                     \
     std::array<float, 2>                                                                 \
-    process(float sampleRate, Wavetable &wavetable, NoteProcessInfo &info);              \
+    process(float sampleRate, const Wavetable &wavetable, NoteProcessInfo &info);        \
   };
 
 NOTE_CLASS(AVX512)
@@ -160,6 +164,7 @@ public:
   virtual void noteOff(int32_t noteId) = 0;
   virtual void refreshTable() = 0;
   virtual void refreshLfo() = 0;
+  virtual bool isTableReady() = 0; // True after the first table is built.
 
   struct MidiNote {
     bool isNoteOn;
@@ -170,7 +175,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   virtual void pushMidiNote(
     bool isNoteOn,
@@ -198,6 +203,7 @@ public:
     void noteOff(int32_t noteId) override;                                               \
     void refreshTable() override;                                                        \
     void refreshLfo() override;                                                          \
+    bool isTableReady() override { return tableWorker.isReady(); }                       \
                                                                                          \
     void pushMidiNote(                                                                   \
       bool isNoteOn,                                                                     \
@@ -214,23 +220,17 @@ public:
       note.pitch = pitch;                                                                \
       note.tuning = tuning;                                                              \
       note.velocity = velocity;                                                          \
-      midiNotes.push_back(note);                                                         \
+      midiNotes.push(note);                                                              \
     }                                                                                    \
                                                                                          \
     void processMidiNote(uint32_t frame) override                                        \
     {                                                                                    \
-      while (true) {                                                                     \
-        auto it                                                                          \
-          = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {   \
-              return nt.frame == frame;                                                  \
-            });                                                                          \
-        if (it == std::end(midiNotes)) return;                                           \
-        if (it->isNoteOn)                                                                \
-          noteOn(it->id, it->pitch, it->tuning, it->velocity);                           \
+      midiNotes.dispatch(frame, [&](const MidiNote &nt) {                                \
+        if (nt.isNoteOn)                                                                 \
+          noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);                               \
         else                                                                             \
-          noteOff(it->id);                                                               \
-        midiNotes.erase(it);                                                             \
-      }                                                                                  \
+          noteOff(nt.id);                                                                \
+      });                                                                                \
     }                                                                                    \
                                                                                          \
   private:                                                                               \
@@ -238,12 +238,18 @@ public:
                                                                                          \
     float sampleRate = 44100.0f;                                                         \
                                                                                          \
-    std::vector<PeakInfo<float>> peakInfos;                                              \
-                                                                                         \
     bool prepareRefresh = true;                                                          \
     bool isTableRefeshed = false;                                                        \
     bool isLFORefreshed = false;                                                         \
-    Wavetable wavetable;                                                                 \
+    TableWorker<Wavetable, PadSynthConfig> tableWorker{                                  \
+      [](const PadSynthConfig &config) {                                                 \
+        return SharedTableCache<Wavetable, PadSynthConfig>::instance().acquire(          \
+          config, [](Wavetable &table, const PadSynthConfig &config) {                   \
+            table.padsynthWithCache(config);                                             \
+          });                                                                            \
+      }};                                                                                \
+    Wavetable silentTable; /* Played until the first table is built. */                  \
+    const Wavetable *wavetable = nullptr; /* Front table. Updated for each block. */     \
     LfoWavetable<lfoTableSize> lfoWavetable;                                             \
                                                                                          \
     size_t nVoice = 32;                                                                  \
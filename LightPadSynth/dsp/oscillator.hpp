@@ -21,12 +21,15 @@
 #include "../../lib/pocketfft/pocketfft_hdronly.h"
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/parallelfor.hpp"
 #include "../../common/dsp/somemath.hpp"
+#include "../../common/dsp/tablecache.hpp"
+#include "../../common/dsp/tablediskcache.hpp"
 
 #include <algorithm>
 #include <cstring>
 #include <deque>
-#include <numeric>
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -50,52 +53,92 @@ template<typename Sample> struct PeakInfo {
   Sample bandWidth = 1;
 };
 
-template<typename T> class PocketFFT {
-public:
-  pocketfft::shape_t shape;
-  pocketfft::stride_t strideR;
-  pocketfft::stride_t strideC;
-  pocketfft::shape_t axes;
-  size_t ndata = 1;
+constexpr size_t initialTableSize = 262144;
+constexpr size_t maxMidiNoteNumber = 128;
 
-  void setShape(pocketfft::shape_t shape)
-  {
-    this->shape = shape;
-
-    strideR.resize(shape.size());
-    strideC.resize(shape.size());
-
-    size_t tmpR = sizeof(T);
-    size_t tmpC = sizeof(std::complex<T>);
-    for (int i = int(shape.size()) - 1; i >= 0; --i) {
-      strideR[i] = tmpR;
-      tmpR *= shape[i];
-      strideC[i] = tmpC;
-      tmpC *= shape[i];
-    }
+// Bump this when the content or the layout of Wavetable changes.
+constexpr uint32_t wavetableCacheVersion = 1;
 
-    ndata = 1;
-    for (const auto &shp : shape) ndata *= shp;
+inline TableDiskCache &wavetableDiskCache()
+{
+  static TableDiskCache cache("LightPadSynth", wavetableCacheVersion);
+  return cache;
+}
 
-    axes.resize(shape.size());
-    std::iota(axes.begin(), axes.end(), 0);
+// Set of parameters which changes the content of Wavetable.
+struct PadSynthConfig {
+  float sampleRate = 44100.0f;
+  float tableBaseFreq = 20.0f;
+  size_t tableSize = initialTableSize;
+  std::vector<PeakInfo<float>> peakInfos;
+  uint32_t seed = 0;
+  float expand = 1.0f;
+  float rotate = 0.0f;
+  uint32_t profileSkip = 1; // 1 or greater.
+  float profileShape = 1.0f;
+  bool uniformPhaseProfile = false;
+
+  uint64_t hash() const
+  {
+    uint64_t h = fnv1a(sampleRate, 0xcbf29ce484222325);
+    h = fnv1a(tableBaseFreq, h);
+    h = fnv1a(tableSize, h);
+    for (const auto &peak : peakInfos) {
+      h = fnv1a(peak.frequency, h);
+      h = fnv1a(peak.gain, h);
+      h = fnv1a(peak.phase, h);
+      h = fnv1a(peak.bandWidth, h);
+    }
+    h = fnv1a(seed, h);
+    h = fnv1a(expand, h);
+    h = fnv1a(rotate, h);
+    h = fnv1a(profileSkip, h);
+    h = fnv1a(profileShape, h);
+    return fnv1a(uniformPhaseProfile, h);
   }
 
-  void r2c(const T *data_in, std::complex<T> *data_out, bool forward = true, T scale = 1)
+  // Stored in TableDiskCache, and compared byte by byte on load.
+  std::vector<uint8_t> serialize() const
   {
-    pocketfft::r2c(shape, strideR, strideC, axes, forward, data_in, data_out, scale);
+    std::vector<uint8_t> bytes;
+    appendBytes(bytes, sampleRate);
+    appendBytes(bytes, tableBaseFreq);
+    appendBytes(bytes, uint64_t(tableSize));
+    appendBytes(bytes, uint64_t(peakInfos.size()));
+    for (const auto &peak : peakInfos) {
+      appendBytes(bytes, peak.frequency);
+      appendBytes(bytes, peak.gain);
+      appendBytes(bytes, peak.phase);
+      appendBytes(bytes, peak.bandWidth);
+    }
+    appendBytes(bytes, seed);
+    appendBytes(bytes, expand);
+    appendBytes(bytes, rotate);
+    appendBytes(bytes, profileSkip);
+    appendBytes(bytes, profileShape);
+    appendBytes(bytes, uniformPhaseProfile);
+    return bytes;
   }
 
-  void c2r(const std::complex<T> *data_in, T *data_out, bool forward = false, T scale = 1)
+  bool operator==(const PadSynthConfig &rhs) const
   {
-    pocketfft::c2r(
-      shape, strideC, strideR, axes, forward, data_in, data_out, scale / ndata);
+    if (peakInfos.size() != rhs.peakInfos.size()) return false;
+    for (size_t i = 0; i < peakInfos.size(); ++i) {
+      const auto &lp = peakInfos[i];
+      const auto &rp = rhs.peakInfos[i];
+      if (
+        lp.frequency != rp.frequency || lp.gain != rp.gain || lp.phase != rp.phase
+        || lp.bandWidth != rp.bandWidth)
+        return false;
+    }
+    return sampleRate == rhs.sampleRate && tableBaseFreq == rhs.tableBaseFreq
+      && tableSize == rhs.tableSize && seed == rhs.seed && expand == rhs.expand
+      && rotate == rhs.rotate && profileSkip == rhs.profileSkip
+      && profileShape == rhs.profileShape
+      && uniformPhaseProfile == rhs.uniformPhaseProfile;
   }
 };
 
-constexpr size_t initialTableSize = 262144;
-constexpr size_t maxMidiNoteNumber = 128;
-
 /**
 Last element of table is padded for linear interpolation.
 For example, consider following table:
@@ -111,15 +154,12 @@ tablePadded = [11, 22, 33, 44, 11].
                                ^ This element is padded.
 ```
  */
-struct Wavetable {
+struct Wavetable : std::enable_shared_from_this<Wavetable> {
   std::vector<std::complex<float>> spectrum;
   std::vector<std::complex<float>> tmpSpec;
   std::vector<std::vector<float>> table;
   float tableBaseFreq = 20.0f;
   size_t tableSize = initialTableSize;
-  PocketFFT<float> fft;
-
-  Wavetable() { resize(initialTableSize); }
 
   void resize(size_t tableSize)
   {
@@ -131,13 +171,70 @@ struct Wavetable {
 
     table.resize(maxMidiNoteNumber);
     for (auto &tbl : table) tbl.resize(tableSize + 1);
-
-    pocketfft::shape_t shape{tableSize};
-    fft.setShape(shape);
   }
 
   size_t getTableSize() { return tableSize; }
 
+  // Header of the payload stored in TableDiskCache. Rows follow it.
+  struct CacheInfo {
+    float tableBaseFreq;
+    uint32_t nTable;
+    uint64_t tableSize;
+  };
+  CacheInfo cacheInfo; // Kept as member, because the disk write is queued.
+
+  // Mapped rows are copied because TableOsc reads `std::vector`. It's still much faster
+  // than running FFT for every row.
+  bool load(std::shared_ptr<MappedTableFile> file, size_t tableSize)
+  {
+    if (!file || file->size() < sizeof(CacheInfo)) return false;
+
+    CacheInfo info;
+    std::memcpy(&info, file->data(), sizeof(CacheInfo));
+    const size_t rowBytes = sizeof(float) * (tableSize + 1);
+    if (
+      info.nTable != maxMidiNoteNumber || info.tableSize != tableSize
+      || file->size() != sizeof(CacheInfo) + maxMidiNoteNumber * rowBytes)
+      return false;
+
+    resize(tableSize);
+    tableBaseFreq = info.tableBaseFreq;
+    const uint8_t *ptr = file->data() + sizeof(CacheInfo);
+    for (auto &tbl : table) {
+      std::memcpy(tbl.data(), ptr, rowBytes);
+      ptr += rowBytes;
+    }
+    return true;
+  }
+
+  // Queued write holds a reference to this table. Without an owner, it writes now.
+  void store(
+    TableDiskCache &cache,
+    uint64_t hash,
+    float sampleRate,
+    const std::vector<uint8_t> &config)
+  {
+    if (!cache.isEnabled()) return;
+
+    cacheInfo = {tableBaseFreq, uint32_t(table.size()), tableSize};
+    std::vector<TableDiskCache::Chunk> chunks{{&cacheInfo, sizeof(CacheInfo)}};
+    for (const auto &tbl : table)
+      chunks.push_back({tbl.data(), sizeof(float) * tbl.size()});
+    cache.store(hash, sampleRate, config, weak_from_this().lock(), std::move(chunks));
+  }
+
+  // Loads the table from disk cache if available. Otherwise the table is computed and
+  // stored to the cache.
+  void padsynthWithCache(const PadSynthConfig &config)
+  {
+    auto &cache = wavetableDiskCache();
+    const auto hash = config.hash();
+    const auto bytes = config.serialize();
+    if (load(cache.load(hash, config.sampleRate, bytes), config.tableSize)) return;
+    padsynth(config);
+    store(cache, hash, config.sampleRate, bytes);
+  }
+
   inline float profile(float fi, float bwi, float shape)
   {
     if (bwi < 1e-5) bwi = 1e-5;
@@ -145,24 +242,26 @@ struct Wavetable {
     return powf(expf(-x * x) / bwi, shape);
   }
 
-  void padsynth(
-    float sampleRate,
-    float tableBaseFreq,
-    std::vector<PeakInfo<float>> &peakInfos,
-    uint32_t seed,
-    float expand,
-    float rotate,
-    uint32_t profileSkip, // 1 or greater.
-    float profileShape,
-    bool uniformPhaseProfile)
+  void padsynth(const PadSynthConfig &config)
   {
+    const float sampleRate = config.sampleRate;
+    const float tableBaseFreq = config.tableBaseFreq;
+    const auto &peakInfos = config.peakInfos;
+    const float expand = config.expand;
+    const float rotate = config.rotate;
+    const float profileShape = config.profileShape;
+    const bool uniformPhaseProfile = config.uniformPhaseProfile;
+    uint32_t profileSkip = config.profileSkip;
+
+    resize(config.tableSize);
+
     if (profileSkip < 1) profileSkip = 1;
 
     this->tableBaseFreq = tableBaseFreq;
 
     for (size_t bin = 1; bin < spectrum.size(); ++bin) spectrum[bin] = 0.0f;
 
-    std::minstd_rand rng(seed);
+    std::minstd_rand rng(config.seed);
     for (const auto &peak : peakInfos) {
       float bandHz = (powf(2.0f, peak.bandWidth / 1200.0f) - 1.0f) * peak.frequency;
       float bandIdx = bandHz / (2.0f * sampleRate);
@@ -219,19 +318,36 @@ struct Wavetable {
       for (auto &bin : spectrum) bin /= sum;
     }
 
-    for (int i = 0; i < int(table.size()); ++i)
-      refreshTable(440.0 * pow(2.0, (i - 69) / 12.0), table[i]);
+    // Tables are independent, so they are computed in parallel. Table itself is used as
+    // the scratch buffer of each worker. Plan is shared because `exec` is const and
+    // allocates its own work buffer.
+    pocketfft::detail::pocketfft_r<float> plan(tableSize);
+    parallelFor(
+      getParallelWorkerCount(table.size()), table.size(), [&](size_t, size_t idx) {
+        refreshTable(plan, 440.0 * pow(2.0, (int(idx) - 69) / 12.0), table[idx]);
+      });
   }
 
-  void refreshTable(float frequency, std::vector<float> &table)
+  void refreshTable(
+    const pocketfft::detail::pocketfft_r<float> &plan,
+    float frequency,
+    std::vector<float> &table)
   {
     size_t bandIdx = size_t(spectrum.size() * tableBaseFreq / frequency);
     bandIdx = std::clamp<size_t>(bandIdx, 1, spectrum.size());
 
-    std::copy_n(spectrum.begin(), bandIdx, tmpSpec.begin());
-    std::fill(tmpSpec.begin() + bandIdx, tmpSpec.end(), 0);
+    // Pack band limited spectrum into FFTPACK halfcomplex order,
+    // [r0, r1, i1, r2, i2, ..., r(n/2)], which is the input of `pocketfft_r::exec`.
+    const size_t nyquist = tableSize / 2;
+    std::fill(table.begin(), table.end(), 0.0f);
+    table[0] = spectrum[0].real();
+    for (size_t bin = 1; bin < std::min(bandIdx, nyquist); ++bin) {
+      table[2 * bin - 1] = spectrum[bin].real();
+      table[2 * bin] = spectrum[bin].imag();
+    }
+    if (bandIdx > nyquist) table[tableSize - 1] = spectrum[nyquist].real();
 
-    fft.c2r(tmpSpec.data(), table.data());
+    plan.exec(table.data(), 1.0f / tableSize, false);
 
     // Fill padded elements.
     table[table.size() - 1] = table[0];
@@ -259,9 +375,17 @@ struct TableOsc {
     this->phase = (phase - floorf(phase)) * tableSize;
   }
 
+  // Moves to other table while keeping normalized phase.
+  void changeTable(float frequency, float tableBaseFreq, size_t fromSize, size_t toSize)
+  {
+    setPhase(phase / fromSize, toSize);
+    tick = frequency / tableBaseFreq;
+    if (tick >= toSize || tick < 0.0f) tick = 0;
+  }
+
   void reset() { phase = 0; }
 
-  float process(std::vector<std::vector<float>> &table, size_t tableSize)
+  float process(const std::vector<std::vector<float>> &table, size_t tableSize)
   {
     const auto &tbl = table[tableIndex];
 
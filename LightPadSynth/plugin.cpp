@@ -134,9 +134,10 @@ protected:
 
   void setState(const char *key, const char *)
   {
-    if (std::strcmp(key, "padsynth") == 0)
+    if (std::strcmp(key, "padsynth") == 0) {
+      dsp->reset();
       dsp->refreshTable();
-    else if (std::strcmp(key, "lfo") == 0)
+    } else if (std::strcmp(key, "lfo") == 0)
       dsp->refreshLfo();
   }
 
@@ -17,116 +17,111 @@
 
 #pragma once
 
+#include "../../common/dsp/delay.hpp"
+#include "../../lib/vcl/vectorclass.h"
+
 #include <algorithm>
+#include <array>
 #include <stdlib.h>
-#include <vector>
 
-template<typename Sample, unsigned char Order> class FractionalDelayLagrange {
-public:
-  void reset()
-  {
-    xd.fill(0.0);
-    diff.fill(0.0);
-  }
+/**
+Stereo delay with 7x upsampling. Both channels are processed in a Vec16f. Lanes 0 to 7
+are left, and lanes 8 to 15 are right.
 
-  void push(Sample input)
-  {
-    diff[0] = input - xd[0];
-    for (size_t i = 1; i < Order; ++i) diff[i] = diff[i - 1] - xd[i];
+Input is upsampled to 7 samples by 7th order Lagrange interpolation. Weights only depend
+on the phase of upsampled sample, so they are precomputed as a polyphase table. 7 phases
+of both channels are computed as a dot product of 8 taps, and lanes 7 and 15 are padding.
+Ring buffers have power of 2 length, and indices are wrapped by mask.
 
-    xd[0] = input;
-    for (size_t i = 1; i < Order; ++i) xd[i] = diff[i - 1];
-  }
+Output is read by linear interpolation at the upsampled rate. It replaced a per-sample
+`DelayLagrange<float, 7>` which evaluated the interpolation by divided differences, and
+the output only differs by rounding.
+*/
+class StereoDelayLagrange7 {
+public:
+  static constexpr size_t order = 7;
+  static constexpr size_t overSample = order;
+  static constexpr size_t nTap = order + 1;
+  static constexpr size_t fix = (overSample * (order - 1)) / 2;
 
-  Sample at(Sample fraction)
+  StereoDelayLagrange7()
   {
-    Sample delta = fraction + (Order - 1) / 2;
-    Sample sig = 0.0;
-
-    size_t i = Order;
-    while (i > 0) {
-      size_t next = i - 1;
-      sig = (next - delta) / i * (diff[next] + sig);
-      i = next;
+    alignas(64) std::array<std::array<float, 16>, nTap> table{};
+    for (size_t phase = 0; phase < overSample; ++phase) {
+      const double fraction = double(overSample - 1 - phase) / overSample;
+      const auto weight = SomeDSP::LagrangeInterp<order>::coefficient(fraction);
+      for (size_t k = 0; k < nTap; ++k) {
+        table[k][phase] = float(weight[nTap - 1 - k]);
+        table[k][8 + phase] = table[k][phase];
+      }
     }
-
-    return sig + xd[0];
+    for (size_t k = 0; k < nTap; ++k) coefficient[k].load_a(table[k].data());
   }
 
-  Sample process(Sample input, Sample fraction)
-  {
-    push(input);
-    return at(fraction);
-  }
-
-private:
-  std::array<Sample, Order> xd{};
-  std::array<Sample, Order> diff{};
-};
-
-template<typename Sample, unsigned char Order> class DelayLagrange {
-public:
-  void setup(Sample sampleRate, Sample time, Sample maxTime)
+  void setup(float sampleRate, float time, float maxTime)
   {
     this->sampleRate = overSample * sampleRate;
 
-    auto size = (size_t)(maxTime * this->sampleRate);
+    auto size = size_t(maxTime * this->sampleRate);
     if (size >= INT32_MAX)
       size = INT32_MAX;
     else if (size == 0)
       size += 1;
-    buf.resize(size, 0.0);
+    maxDelay = float(size);
+    for (auto &rng : ring) rng.setup(size);
 
-    setTime(time);
+    setTime(time, time);
+    reset();
   }
 
-  void setTime(Sample value)
+  void setTime(float timeL, float timeR)
   {
-    auto timeInSample
-      = std::max<Sample>(fix, std::min<Sample>(sampleRate * value, (Sample)buf.size()));
-
-    int32_t time_int = (int32_t)timeInSample;
-    rFraction = timeInSample - (Sample)time_int;
-
-    rptr = wptr - time_int + fix;
-    while (rptr < 0) rptr += (int32_t)buf.size();
+    const std::array<float, 2> seconds{timeL, timeR};
+    for (size_t ch = 0; ch < 2; ++ch) {
+      const auto timeInSample
+        = std::max<float>(fix, std::min<float>(sampleRate * seconds[ch], maxDelay));
+      const auto timeInt = size_t(timeInSample);
+      rFraction[ch] = timeInSample - float(timeInt);
+      rDelay[ch] = timeInt - fix;
+    }
   }
 
   void reset()
   {
-    std::fill(buf.begin(), buf.end(), 0.0);
-    wInterp.reset();
+    for (auto &rng : ring) rng.reset();
+    history.fill(Vec16f(0.0f));
   }
 
-  Sample process(Sample input)
+  std::array<float, 2> process(float inL, float inR)
   {
-    wInterp.push(input);
+    hptr = (hptr - 1) & (nTap - 1);
+    history[hptr] = Vec16f(Vec8f(inL), Vec8f(inR));
 
-    for (size_t i = 1; i <= overSample; ++i) {
-      Sample wFraction = (overSample - (Sample)i) / overSample;
+    Vec16f sum = coefficient[0] * history[hptr];
+    for (size_t k = 1; k < nTap; ++k)
+      sum = mul_add(coefficient[k], history[(hptr + k) & (nTap - 1)], sum);
 
-      buf[wptr] = wInterp.at(wFraction);
-      wptr += 1;
-      while ((size_t)wptr >= buf.size()) wptr -= (int32_t)buf.size();
-    }
+    alignas(64) std::array<float, 16> upsampled;
+    sum.store_a(upsampled.data());
 
-    rptr += overSample;
-    while (rptr >= (int32_t)buf.size()) rptr -= (int32_t)buf.size();
-    int32_t i0 = rptr - 1;
-    while (i0 < 0) i0 += (int32_t)buf.size();
-    int32_t i1 = rptr - 2;
-    while (i1 < 0) i1 += (int32_t)buf.size();
+    std::array<float, 2> out;
+    for (size_t ch = 0; ch < 2; ++ch) {
+      ring[ch].write(upsampled.data() + 8 * ch, overSample);
 
-    return buf[i0] - rFraction * (buf[i0] - buf[i1]);
+      const float x0 = ring[ch].at(rDelay[ch]);
+      out[ch] = x0 - rFraction[ch] * (x0 - ring[ch].at(rDelay[ch] + 1));
+    }
+    return out;
   }
 
 private:
-  static const size_t overSample = Order;
-  static const size_t fix = (overSample * (Order - 1)) / 2;
-  Sample sampleRate = 44100.0;
-  Sample rFraction = 0.0;
-  std::vector<Sample> buf{1};
-  int32_t wptr = 0;
-  int32_t rptr = 0;
-  FractionalDelayLagrange<Sample, Order> wInterp;
+  std::array<Vec16f, nTap> coefficient; // Index is delay of input in samples.
+  std::array<Vec16f, nTap> history{};   // Input broadcasted to each half.
+  size_t hptr = 0;
+
+  float sampleRate = 44100.0f;
+  float maxDelay = 1.0f;
+  std::array<float, 2> rFraction{};
+  std::array<size_t, 2> rDelay{}; // Delay of the newer read tap in upsampled samples.
+  std::array<SomeDSP::RingBuffer<float>, 2> ring;
 };
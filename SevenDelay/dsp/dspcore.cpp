@@ -25,12 +25,25 @@ float clamp(float value, float min, float max)
   return (value < min) ? min : (value > max) ? max : value;
 }
 
+inline float lfoAt(double phase, float shape, float pi)
+{
+  auto sign = (pi < phase) - (phase < pi);
+  return sign * powf(fabsf(sin(phase)), shape);
+}
+
+inline float toneCutoffAt(float lfo, float lfoToneAmount, float cutoff)
+{
+  const float lfoTone = lfoToneAmount * (0.5f * lfo + 0.5f);
+  const float toneCutoff = cutoff * lfoTone * lfoTone;
+  return toneCutoff < 20.0f ? 20.0f : toneCutoff;
+}
+
 void DSPCore::setup(double sampleRate)
 {
+  this->sampleRate = sampleRate;
   SmootherCommon<float>::setSampleRate(sampleRate);
 
-  for (size_t i = 0; i < delay.size(); ++i)
-    delay[i].setup(sampleRate, 1.0f, maxDelayTime);
+  delay.setup(sampleRate, 1.0f, maxDelayTime);
 
   for (size_t i = 0; i < filter.size(); ++i) filter[i].setup(sampleRate);
 
@@ -38,18 +51,22 @@ void DSPCore::setup(double sampleRate)
 
   lfoPhaseTick = twopi / sampleRate;
 
+  // Residue in a delay buffer comes out within its length.
+  silence.setup(sampleRate, 2 * maxDelayTime);
+
   startup();
 }
 
 void DSPCore::reset()
 {
+  delay.reset();
   for (size_t i = 0; i < channel; ++i) {
-    delay[i].reset();
     filter[i].reset();
     dcKiller[i].reset();
   }
 
   delayOut.fill(0.0f);
+  silence.reset();
 
   interpToneMix.reset(0);
   interpDCKillMix.reset(0);
@@ -62,11 +79,13 @@ void DSPCore::startup()
   delayOut[0] = 0.0f;
   delayOut[1] = 0.0f;
   lfoPhase = param.value[ParameterID::lfoInitialPhase]->getFloat();
+  lastToneCutoff = -1;
 }
 
 void DSPCore::setParameters(double tempo)
 {
   SmootherCommon<float>::setTime(param.value[ParameterID::smoothness]->getFloat());
+  silence.setEnabled(param.value[ParameterID::autoSleep]->getInt());
 
   // This won't work if sync is on and tempo < 15. Up to 8 sec or 8/16 beat.
   // 15.0 is come from (60 sec per minute) * (4 beat) / (16 beat).
@@ -134,57 +153,151 @@ void DSPCore::setParameters(double tempo)
     Scales::dckillMix.reverseMap(param.value[ParameterID::dckill]->getNormalized()));
 }
 
+/**
+Fills `ctrl` for next `length` samples, and returns true when LFO and coefficients are
+interpolated. Otherwise `process` sets coefficients on every sample.
+
+Smoothers and LFO phase advance on every sample, so the values at the ends of interval
+are the same as per sample evaluation. Interpolation starts from the last sample of
+previous interval. Static coefficients are not recomputed.
+*/
+bool DSPCore::updateControl(size_t length, bool lfoHold)
+{
+  for (size_t j = 0; j < length; ++j) {
+    ctrl.lfoPhase[j] = lfoPhase;
+    ctrl.lfoShape[j] = interpLfoShape.process();
+    ctrl.lfoTimeAmount[j] = interpLfoTimeAmount.process();
+    ctrl.lfoToneAmount[j] = interpLfoToneAmount.process();
+    ctrl.toneCutoff[j] = interpToneCutoff.process();
+    ctrl.toneQ[j] = interpToneQ.process();
+    ctrl.dckill[j] = interpDCKill.process();
+
+    if (!lfoHold) {
+      lfoPhase += interpLfoFrequency.process() * lfoPhaseTick;
+      if (lfoPhase > twopi) lfoPhase -= pi;
+    }
+  }
+
+  const size_t last = length - 1;
+  const size_t mid = last / 2;
+  const float lfoEnd = lfoAt(ctrl.lfoPhase[last], ctrl.lfoShape[last], pi);
+  const float lfoMid = lfoAt(ctrl.lfoPhase[mid], ctrl.lfoShape[mid], pi);
+  const float cutoffEnd
+    = toneCutoffAt(lfoEnd, ctrl.lfoToneAmount[last], ctrl.toneCutoff[last]);
+
+  bool isInterpolated = lastToneCutoff >= 0;
+  if (isInterpolated) {
+    const float ratio = float(mid + 1) / float(length);
+    const float lfoError = lfoMid - (lastLfo + ratio * (lfoEnd - lastLfo));
+    const float cutoffMid
+      = toneCutoffAt(lfoMid, ctrl.lfoToneAmount[mid], ctrl.toneCutoff[mid]);
+    const float cutoffError
+      = cutoffMid - (lastToneCutoff + ratio * (cutoffEnd - lastToneCutoff));
+    isInterpolated
+      = fabsf(ctrl.lfoTimeAmount[mid] * lfoError) * sampleRate <= maxTimeError
+      && fabsf(cutoffError) <= maxCutoffError * cutoffMid;
+  }
+
+  if (isInterpolated) {
+    const float step = 1.0f / float(length);
+    for (size_t j = 0; j < last; ++j)
+      ctrl.lfo[j] = lastLfo + float(j + 1) * step * (lfoEnd - lastLfo);
+    ctrl.lfo[last] = lfoEnd;
+
+    const float toneQ = ctrl.toneQ[last];
+    if (cutoffEnd != lastToneCutoff || toneQ != lastToneQ) {
+      filter[0].rampCutoffQ(cutoffEnd, toneQ, length);
+      filter[1].rampCutoffQ(cutoffEnd, toneQ, length);
+    }
+    if (ctrl.dckill[last] != lastDCKill) {
+      dcKiller[0].rampCutoff(ctrl.dckill[last], length);
+      dcKiller[1].rampCutoff(ctrl.dckill[last], length);
+    }
+  } else {
+    for (size_t j = 0; j < length; ++j)
+      ctrl.lfo[j] = lfoAt(ctrl.lfoPhase[j], ctrl.lfoShape[j], pi);
+  }
+
+  lastLfo = lfoEnd;
+  lastToneCutoff = cutoffEnd;
+  lastToneQ = ctrl.toneQ[last];
+  lastDCKill = ctrl.dckill[last];
+  return isInterpolated;
+}
+
 void DSPCore::process(
   const size_t length, const float *in0, const float *in1, float *out0, float *out1)
 {
   SmootherCommon<float>::setBufferSize(length);
 
-  for (size_t i = 0; i < length; ++i) {
-    auto sign = (pi < lfoPhase) - (lfoPhase < pi);
-    const float lfo = sign * powf(fabsf(sin(lfoPhase)), interpLfoShape.process());
-    const float lfoTime = interpLfoTimeAmount.process() * (1.0f + lfo);
-
-    delay[0].setTime(interpTime[0].process() + lfoTime);
-    delay[1].setTime(interpTime[1].process() + lfoTime);
-
-    const float feedback = interpFeedback.process();
-    const float inL = in0[i] + feedback * delayOut[0];
-    const float inR = in1[i] + feedback * delayOut[1];
-    delayOut[0] = delay[0].process(inL + interpPanIn[0].process() * (inR - inL));
-    delayOut[1] = delay[1].process(inL + interpPanIn[1].process() * (inR - inL));
-
-    const float lfoTone = interpLfoToneAmount.process() * (0.5f * lfo + 0.5f);
-    float toneCutoff = interpToneCutoff.process() * lfoTone * lfoTone;
-    if (toneCutoff < 20.0f) toneCutoff = 20.0f;
-    const float toneQ = interpToneQ.process();
-    filter[0].setCutoffQ(toneCutoff, toneQ);
-    filter[1].setCutoffQ(toneCutoff, toneQ);
-    float filterOutL = filter[0].process(delayOut[0]);
-    float filterOutR = filter[1].process(delayOut[1]);
-    const float toneMix = interpToneMix.process();
-    delayOut[0] = filterOutL + toneMix * (delayOut[0] - filterOutL);
-    delayOut[1] = filterOutR + toneMix * (delayOut[1] - filterOutR);
-
-    const float dckill = interpDCKill.process();
-    dcKiller[0].setCutoff(dckill);
-    dcKiller[1].setCutoff(dckill);
-    filterOutL = dcKiller[0].process(delayOut[0]);
-    filterOutR = dcKiller[1].process(delayOut[1]);
-    const float dckillMix = interpDCKillMix.process();
-    // dckillmix == 1 -> delayout
-    delayOut[0] = filterOutL + dckillMix * (delayOut[0] - filterOutL);
-    delayOut[1] = filterOutR + dckillMix * (delayOut[1] - filterOutR);
-
-    const float wet = interpWetMix.process();
-    const float dry = interpDryMix.process();
-    const float outL = wet * delayOut[0];
-    const float outR = wet * delayOut[1];
-    out0[i] = dry * in0[i] + outL + interpPanOut[0].process() * (outR - outL);
-    out1[i] = dry * in1[i] + outL + interpPanOut[1].process() * (outR - outL);
-
-    if (!(param.value[ParameterID::lfoHold]->getInt())) {
-      lfoPhase += interpLfoFrequency.process() * lfoPhaseTick;
-      if (lfoPhase > twopi) lfoPhase -= pi;
+  const bool lfoHold = param.value[ParameterID::lfoHold]->getInt();
+
+  // LFO keeps running while sleeping, so that the phase on wake up is the same as the
+  // one without sleep.
+  if (silence.isSleeping(length, in0, in1)) {
+    std::fill(out0, out0 + length, 0.0f);
+    std::fill(out1, out1 + length, 0.0f);
+    if (!lfoHold) {
+      for (size_t i = 0; i < length; ++i) {
+        lfoPhase += interpLfoFrequency.process() * lfoPhaseTick;
+        if (lfoPhase > twopi) lfoPhase -= pi;
+      }
+    }
+    lastToneCutoff = -1;
+    return;
+  }
+
+  size_t i = 0;
+  while (i < length) {
+    const size_t interval = std::min(controlInterval, length - i);
+    const bool isInterpolated = updateControl(interval, lfoHold);
+
+    for (size_t j = 0; j < interval; ++j, ++i) {
+      const float lfoTime = ctrl.lfoTimeAmount[j] * (1.0f + ctrl.lfo[j]);
+
+      const float timeL = interpTime[0].process() + lfoTime;
+      const float timeR = interpTime[1].process() + lfoTime;
+      delay.setTime(timeL, timeR);
+
+      const float feedback = interpFeedback.process();
+      const float inL = in0[i] + feedback * delayOut[0];
+      const float inR = in1[i] + feedback * delayOut[1];
+      const float panInL = interpPanIn[0].process();
+      const float panInR = interpPanIn[1].process();
+      delayOut = delay.process(inL + panInL * (inR - inL), inL + panInR * (inR - inL));
+
+      if (!isInterpolated) {
+        const float toneCutoff
+          = toneCutoffAt(ctrl.lfo[j], ctrl.lfoToneAmount[j], ctrl.toneCutoff[j]);
+        filter[0].setCutoffQ(toneCutoff, ctrl.toneQ[j]);
+        filter[1].setCutoffQ(toneCutoff, ctrl.toneQ[j]);
+        dcKiller[0].setCutoff(ctrl.dckill[j]);
+        dcKiller[1].setCutoff(ctrl.dckill[j]);
+      }
+
+      float filterOutL = filter[0].process(delayOut[0]);
+      float filterOutR = filter[1].process(delayOut[1]);
+      const float toneMix = interpToneMix.process();
+      delayOut[0] = filterOutL + toneMix * (delayOut[0] - filterOutL);
+      delayOut[1] = filterOutR + toneMix * (delayOut[1] - filterOutR);
+
+      filterOutL = dcKiller[0].process(delayOut[0]);
+      filterOutR = dcKiller[1].process(delayOut[1]);
+      const float dckillMix = interpDCKillMix.process();
+      // dckillmix == 1 -> delayout
+      delayOut[0] = filterOutL + dckillMix * (delayOut[0] - filterOutL);
+      delayOut[1] = filterOutR + dckillMix * (delayOut[1] - filterOutR);
+      silence.track(delayOut[0]);
+      silence.track(delayOut[1]);
+
+      const float wet = interpWetMix.process();
+      const float dry = interpDryMix.process();
+      const float outL = wet * delayOut[0];
+      const float outR = wet * delayOut[1];
+      out0[i] = dry * in0[i] + outL + interpPanOut[0].process() * (outR - outL);
+      out1[i] = dry * in1[i] + outL + interpPanOut[1].process() * (outR - outL);
     }
   }
+
+  silence.endBlock(length);
 }
@@ -17,16 +17,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <memory>
 
+#include "../../common/dsp/silencedetector.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "delay.hpp"
 #include "iir.hpp"
 
-// Lagrange delay is very slow at debug build. If that's the case set Order to 1.
-using DelayTypeName = DelayLagrange<float, 7>;
+using DelayTypeName = StereoDelayLagrange7;
 using FilterTypeName = SomeDSP::SVF<float>;
 using DCKillerTypeName = SomeDSP::BiquadHighPass<float>;
 
@@ -43,7 +44,28 @@ public:
   void process(
     const size_t length, const float *in0, const float *in1, float *out0, float *out1);
 
+  /**
+  LFO and filter coefficients are evaluated on every `controlInterval` samples, and
+  linearly interpolated in between. An interval falls back to per sample evaluation
+  when the interpolation error at its middle exceeds `maxTimeError` samples of delay
+  time or `maxCutoffError` relative to tone cutoff. It happens on deep and fast
+  modulation, or on sharp LFO shape.
+
+  `interval` is clamped to [1, maxControlInterval]. 1 evaluates on every sample.
+  */
+  void setControlInterval(size_t interval)
+  {
+    controlInterval = std::clamp<size_t>(interval, 1, maxControlInterval);
+  }
+
+  static constexpr size_t defaultControlInterval = 16;
+  static constexpr size_t maxControlInterval = 64;
+  static constexpr float maxTimeError = 0.01f;
+  static constexpr float maxCutoffError = 1e-3f;
+
 protected:
+  bool updateControl(size_t length, bool lfoHold);
+
   const float pi = 3.14159265358979323846;
 
   std::array<LinearSmoother<float>, 2> interpTime{};
@@ -62,10 +84,33 @@ protected:
   LinearSmoother<float> interpDCKill;
   LinearSmoother<float> interpDCKillMix;
 
+  float sampleRate = 44100.0f;
+  size_t controlInterval = defaultControlInterval;
   double lfoPhase;
   double lfoPhaseTick;
+
+  // Values of each sample in a control interval. `lfo` is interpolated.
+  struct ControlBuffer {
+    std::array<double, maxControlInterval> lfoPhase{};
+    std::array<float, maxControlInterval> lfo{};
+    std::array<float, maxControlInterval> lfoShape{};
+    std::array<float, maxControlInterval> lfoTimeAmount{};
+    std::array<float, maxControlInterval> lfoToneAmount{};
+    std::array<float, maxControlInterval> toneCutoff{};
+    std::array<float, maxControlInterval> toneQ{};
+    std::array<float, maxControlInterval> dckill{};
+  } ctrl;
+
+  // Values at the last sample of previous interval. Negative `lastToneCutoff` means
+  // that the next interval can't be interpolated.
+  float lastLfo = 0;
+  float lastToneCutoff = -1;
+  float lastToneQ = 0;
+  float lastDCKill = 0;
+
   std::array<float, 2> delayOut{};
-  std::array<DelayTypeName, 2> delay;
+  DelayTypeName delay;
   std::array<FilterTypeName, 2> filter;
   std::array<DCKillerTypeName, 2> dcKiller;
+  SilenceDetector silence;
 };
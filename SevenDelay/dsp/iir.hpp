@@ -19,7 +19,9 @@
 
 #include "../../common/dsp/constants.hpp"
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 
 namespace SomeDSP {
 
@@ -49,6 +51,32 @@ public:
     cutoff = hz > 0.0 ? hz : 0.0;
     resonance = q < Sample(1e-5) ? Sample(1e-5) : q;
     setCoefficient();
+    rampCounter = 0;
+  }
+
+  /**
+  Moves coefficients linearly to the ones of `hz` and `q`. They are reached at the
+  `nSample`-th call of `process`, and stay there. For coefficients updated at control
+  rate. `setCutoffQ` stops the ramp.
+  */
+  void rampCutoffQ(Sample hz, Sample q, size_t nSample)
+  {
+    const Sample g0 = g;
+    const Sample g10 = g1;
+    const Sample d0 = d;
+    const Sample twoR0 = twoR;
+
+    setCutoffQ(hz, q);
+    if (nSample <= 1) return;
+
+    target = {g, g1, d, twoR};
+    const Sample step = Sample(1) / Sample(nSample);
+    ramp = {(g - g0) * step, (g1 - g10) * step, (d - d0) * step, (twoR - twoR0) * step};
+    g = g0;
+    g1 = g10;
+    d = d0;
+    twoR = twoR0;
+    rampCounter = nSample;
   }
 
   void reset()
@@ -59,6 +87,8 @@ public:
 
   Sample process(Sample input)
   {
+    if (rampCounter > 0) updateRamp();
+
     yHP = (input - g1 * s1 - s2) * d;
 
     Sample v1 = g * yHP;
@@ -77,6 +107,21 @@ public:
   }
 
 protected:
+  void updateRamp()
+  {
+    if (--rampCounter == 0) {
+      g = target[0];
+      g1 = target[1];
+      d = target[2];
+      twoR = target[3];
+    } else {
+      g += ramp[0];
+      g1 += ramp[1];
+      d += ramp[2];
+      twoR += ramp[3];
+    }
+  }
+
   Sample sampleRate = 44100;
   Sample cutoff = 0.5;
   Sample resonance = 0.5;
@@ -92,6 +137,10 @@ protected:
   Sample g1 = 0.0;
   Sample d = 0.0;
   Sample twoR = 0.0;
+
+  size_t rampCounter = 0;
+  std::array<Sample, 4> target{}; // g, g1, d, twoR.
+  std::array<Sample, 4> ramp{};
 };
 
 // http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
@@ -110,10 +159,32 @@ public:
     a0 = a1 = a2 = 0.0;
     x1 = x2 = 0.0;
     y1 = y2 = 0.0;
+    rampCounter = 0;
+  }
+
+  // Same as `SVF::rampCutoffQ`. `setCutoff` stops the ramp.
+  void rampCutoff(Sample hz, size_t nSample)
+  {
+    const std::array<Sample, 5> start{b0, b1, b2, a1, a2};
+
+    setCutoff(hz);
+    if (nSample <= 1) return;
+
+    target = {b0, b1, b2, a1, a2};
+    const Sample step = Sample(1) / Sample(nSample);
+    for (size_t i = 0; i < ramp.size(); ++i) ramp[i] = (target[i] - start[i]) * step;
+    b0 = start[0];
+    b1 = start[1];
+    b2 = start[2];
+    a1 = start[3];
+    a2 = start[4];
+    rampCounter = nSample;
   }
 
   void setCutoff(Sample hz)
   {
+    rampCounter = 0;
+
     f0 = hz > 0.0 ? hz : 0.0;
 
     Sample w0 = Sample(twopi) * f0 / fs;
@@ -137,6 +208,8 @@ public:
 
   Sample process(Sample input)
   {
+    if (rampCounter > 0) updateRamp();
+
     Sample output = b0 * input + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
 
     x2 = x1;
@@ -149,6 +222,23 @@ public:
   }
 
 protected:
+  void updateRamp()
+  {
+    if (--rampCounter == 0) {
+      b0 = target[0];
+      b1 = target[1];
+      b2 = target[2];
+      a1 = target[3];
+      a2 = target[4];
+    } else {
+      b0 += ramp[0];
+      b1 += ramp[1];
+      b2 += ramp[2];
+      a1 += ramp[3];
+      a2 += ramp[4];
+    }
+  }
+
   Sample fs = 44100;
   Sample f0 = 0.5;
   Sample q = 0.5;
@@ -163,6 +253,10 @@ protected:
   Sample x2 = 0.0;
   Sample y1 = 0.0;
   Sample y2 = 0.0;
+
+  size_t rampCounter = 0;
+  std::array<Sample, 5> target{}; // b0, b1, b2, a1, a2.
+  std::array<Sample, 5> ramp{};
 };
 
 } // namespace SomeDSP
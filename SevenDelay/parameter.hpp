@@ -21,6 +21,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -62,6 +63,7 @@ enum ID {
   toneCutoff,
   toneQ,
   dckill,
+  autoSleep,
 
   ID_ENUM_LENGTH,
 };
@@ -154,6 +156,8 @@ struct GlobalParameter : public ParameterInterface {
       = std::make_unique<LogValue>(0.9, Scales::toneQ, "toneQ", kParameterIsAutomable);
     value[ID::dckill]
       = std::make_unique<LogValue>(0.0, Scales::dckill, "dckill", kParameterIsAutomable);
+    value[ID::autoSleep] = std::make_unique<IntValue>(
+      0, Scales::boolScale, "autoSleep", kParameterIsAutomable | kParameterIsBoolean);
   }
 
 #ifndef TEST_BUILD
@@ -255,7 +259,7 @@ struct GlobalParameter : public ParameterInterface {
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index) override;
-#endif
 };
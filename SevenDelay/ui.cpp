@@ -153,6 +153,9 @@ public:
     addCheckbox(
       delayLeft + 10.0f, delayTop3, checkboxWidth, labelHeight, uiTextSize, "Negative",
       ParameterID::negativeFeedback);
+    addCheckbox(
+      delayLeft + 10.0f, delayTop4, checkboxWidth, labelHeight, uiTextSize, "Sleep",
+      ParameterID::autoSleep);
 
     addKnob(
       1.0f * interval + delayLeft, delayTop2, smallWidth, margin, uiTextSize, "In Spread",
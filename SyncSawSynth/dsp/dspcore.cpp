@@ -255,9 +255,13 @@ void DSPCore::setup(double sampleRate)
   for (auto &note : notes) {
     for (auto &nt : note) nt = std::make_unique<Note<float>>(sampleRate);
   }
+  for (auto &ghost : ghosts) {
+    for (auto &nt : ghost) nt = std::make_unique<Note<float>>(sampleRate);
+  }
+  ghostCounter.fill(0);
 
-  // 2 msec + 1 sample transition time.
-  transitionBuffer.resize(1 + int(sampleRate * 0.005), 0.0);
+  // 5 msec + 1 sample transition time.
+  ghostFadeLength = 1 + int(sampleRate * 0.005);
 
   startup();
 }
@@ -269,6 +273,10 @@ void DSPCore::reset()
   for (auto &note : notes) {
     for (auto &nt : note) nt->rest();
   }
+  for (auto &ghost : ghosts) {
+    for (auto &nt : ghost) nt->rest();
+  }
+  ghostCounter.fill(0);
   startup();
 }
 
@@ -384,66 +392,78 @@ void DSPCore::process(const size_t length, float *out0, float *out1)
   noteInfo.osc1PTROrder = param.value[ParameterID::osc1PTROrder]->getInt();
   noteInfo.osc2SyncType = param.value[ParameterID::osc2SyncType]->getInt();
   noteInfo.osc2PTROrder = param.value[ParameterID::osc2PTROrder]->getInt();
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    noteInfo.osc1Gain = interpOsc1Gain.process();
-    noteInfo.osc1Pitch = interpOsc1Pitch.process();
-    noteInfo.osc1Sync = interpOsc1Sync.process();
-    noteInfo.osc2Gain = interpOsc2Gain.process();
-    noteInfo.osc2Pitch = interpOsc2Pitch.process();
-    noteInfo.osc2Sync = interpOsc2Sync.process();
-    noteInfo.fmOsc1ToSync1 = interpFMOsc1ToSync1.process();
-    noteInfo.fmOsc1ToFreq2 = interpFMOsc1ToFreq2.process();
-    noteInfo.fmOsc2ToSync1 = interpFMOsc2ToSync1.process();
-    noteInfo.modEnvelopeToFreq1 = interpModEnvelopeToFreq1.process();
-    noteInfo.modEnvelopeToSync1 = interpModEnvelopeToSync1.process();
-    noteInfo.modEnvelopeToFreq2 = interpModEnvelopeToFreq2.process();
-    noteInfo.modEnvelopeToSync2 = interpModEnvelopeToSync2.process();
-
-    lfoPhase += 2.0 * float(pi) * interpModLFOFrequency.process() / sampleRate;
-    if (lfoPhase >= float(pi)) lfoPhase -= float(pi);
-    lfoValue = sinf(lfoPhase);
-    // lfoValue = (lfoValue + 1.0f) * 0.5f;
-    const float noiseSig = clamp(noise.process(), -1.0f, 1.0f) / 16.0f;
-    noteInfo.modLFO = clamp(
-      lfoValue + interpModLFONoiseMix.process() * (noiseSig - lfoValue), -1.0f, 1.0f);
-
-    noteInfo.modLFOToFreq1 = interpModLFOToFreq1.process();
-    noteInfo.modLFOToSync1 = interpModLFOToSync1.process();
-    noteInfo.modLFOToFreq2 = interpModLFOToFreq2.process();
-    noteInfo.modLFOToSync2 = interpModLFOToSync2.process();
-    noteInfo.gainEnvelopeCurve = interpGainEnvelopeCurve.process();
-    noteInfo.filterCutoff = interpFilterCutoff.process();
-    noteInfo.filterResonance = interpFilterResonance.process();
-    noteInfo.filterFeedback = interpFilterFeedback.process();
-    noteInfo.filterSaturation = interpFilterSaturation.process();
-    noteInfo.filterCutoffAmount = interpFilterCutoffAmount.process();
-    noteInfo.filterResonanceAmount = interpFilterResonanceAmount.process();
-    noteInfo.filterKeyToCutoff = interpFilterKeyToCutoff.process();
-    noteInfo.filterKeyToFeedback = interpFilterKeyToFeedback.process();
-
-    float sample = 0.0f;
-    for (auto &note : notes) {
-      if (note[0]->state == NoteState::rest) continue;
-      sample += note[0]->process(noteInfo);
-      if (unison) {
-        if (note[1]->state == NoteState::rest) continue;
-        sample += note[1]->process(noteInfo);
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      noteInfo.osc1Gain = interpOsc1Gain.process();
+      noteInfo.osc1Pitch = interpOsc1Pitch.process();
+      noteInfo.osc1Sync = interpOsc1Sync.process();
+      noteInfo.osc2Gain = interpOsc2Gain.process();
+      noteInfo.osc2Pitch = interpOsc2Pitch.process();
+      noteInfo.osc2Sync = interpOsc2Sync.process();
+      noteInfo.fmOsc1ToSync1 = interpFMOsc1ToSync1.process();
+      noteInfo.fmOsc1ToFreq2 = interpFMOsc1ToFreq2.process();
+      noteInfo.fmOsc2ToSync1 = interpFMOsc2ToSync1.process();
+      noteInfo.modEnvelopeToFreq1 = interpModEnvelopeToFreq1.process();
+      noteInfo.modEnvelopeToSync1 = interpModEnvelopeToSync1.process();
+      noteInfo.modEnvelopeToFreq2 = interpModEnvelopeToFreq2.process();
+      noteInfo.modEnvelopeToSync2 = interpModEnvelopeToSync2.process();
+
+      lfoPhase += 2.0 * float(pi) * interpModLFOFrequency.process() / sampleRate;
+      if (lfoPhase >= float(pi)) lfoPhase -= float(pi);
+      lfoValue = sinf(lfoPhase);
+      // lfoValue = (lfoValue + 1.0f) * 0.5f;
+      const float noiseSig = clamp(noise.process(), -1.0f, 1.0f) / 16.0f;
+      noteInfo.modLFO = clamp(
+        lfoValue + interpModLFONoiseMix.process() * (noiseSig - lfoValue), -1.0f, 1.0f);
+
+      noteInfo.modLFOToFreq1 = interpModLFOToFreq1.process();
+      noteInfo.modLFOToSync1 = interpModLFOToSync1.process();
+      noteInfo.modLFOToFreq2 = interpModLFOToFreq2.process();
+      noteInfo.modLFOToSync2 = interpModLFOToSync2.process();
+      noteInfo.gainEnvelopeCurve = interpGainEnvelopeCurve.process();
+      noteInfo.filterCutoff = interpFilterCutoff.process();
+      noteInfo.filterResonance = interpFilterResonance.process();
+      noteInfo.filterFeedback = interpFilterFeedback.process();
+      noteInfo.filterSaturation = interpFilterSaturation.process();
+      noteInfo.filterCutoffAmount = interpFilterCutoffAmount.process();
+      noteInfo.filterResonanceAmount = interpFilterResonanceAmount.process();
+      noteInfo.filterKeyToCutoff = interpFilterKeyToCutoff.process();
+      noteInfo.filterKeyToFeedback = interpFilterKeyToFeedback.process();
+
+      float sample = 0.0f;
+      for (auto &note : notes) {
+        if (note[0]->state == NoteState::rest) continue;
+        sample += note[0]->process(noteInfo);
+        if (unison) {
+          if (note[1]->state == NoteState::rest) continue;
+          sample += note[1]->process(noteInfo);
+        }
       }
-    }
 
-    if (isTransitioning) {
-      sample += transitionBuffer[mptIndex];
-      transitionBuffer[mptIndex] = 0.0f;
-      mptIndex = (mptIndex + 1) % transitionBuffer.size();
-      if (mptIndex == mptStop) isTransitioning = false;
-    }
+      for (size_t idx = 0; idx < nGhost; ++idx) {
+        if (ghostCounter[idx] == 0) continue;
+        auto &ghost = ghosts[idx];
+        if (ghost[0]->state == NoteState::rest) {
+          ghostCounter[idx] = 0;
+          continue;
+        }
+
+        float ghostSig = ghost[0]->process(noteInfo);
+        if (unison && ghost[1]->state != NoteState::rest)
+          ghostSig += ghost[1]->process(noteInfo);
+        const float fade = float(ghostFadeLength - ghostCounter[idx]) / ghostFadeLength;
+        sample += ghostSig * (0.5f + 0.5f * cosf(float(pi) * fade));
+        --ghostCounter[idx];
+      }
 
-    const float masterGain = interpMasterGain.process();
-    out0[i] = masterGain * sample;
-    out1[i] = masterGain * sample;
+      const float masterGain = interpMasterGain.process();
+      out0[i] = masterGain * sample;
+      out1[i] = masterGain * sample;
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
@@ -460,62 +480,16 @@ void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity
     }
   }
   if (i >= nVoice) {
-    isTransitioning = true;
-
     i = mostSilent;
 
-    noteInfo.osc1Gain = interpOsc1Gain.getValue();
-    noteInfo.osc1Pitch = interpOsc1Pitch.getValue();
-    noteInfo.osc1Sync = interpOsc1Sync.getValue();
-    noteInfo.osc1SyncType = param.value[ParameterID::osc1SyncType]->getInt();
-    noteInfo.osc1PTROrder = param.value[ParameterID::osc1PTROrder]->getInt();
-    noteInfo.osc2Gain = interpOsc2Gain.getValue();
-    noteInfo.osc2Pitch = interpOsc2Pitch.getValue();
-    noteInfo.osc2Sync = interpOsc2Sync.getValue();
-    noteInfo.osc2SyncType = param.value[ParameterID::osc2SyncType]->getInt();
-    noteInfo.osc2PTROrder = param.value[ParameterID::osc2PTROrder]->getInt();
-    noteInfo.fmOsc1ToSync1 = interpFMOsc1ToSync1.getValue();
-    noteInfo.fmOsc1ToFreq2 = interpFMOsc1ToFreq2.getValue();
-    noteInfo.fmOsc2ToSync1 = interpFMOsc2ToSync1.getValue();
-    noteInfo.modEnvelopeToFreq1 = interpModEnvelopeToFreq1.getValue();
-    noteInfo.modEnvelopeToSync1 = interpModEnvelopeToSync1.getValue();
-    noteInfo.modEnvelopeToFreq2 = interpModEnvelopeToFreq2.getValue();
-    noteInfo.modEnvelopeToSync2 = interpModEnvelopeToSync2.getValue();
-    noteInfo.modLFO = lfoValue;
-    noteInfo.modLFOToFreq1 = interpModLFOToFreq1.getValue();
-    noteInfo.modLFOToSync1 = interpModLFOToSync1.getValue();
-    noteInfo.modLFOToFreq2 = interpModLFOToFreq2.getValue();
-    noteInfo.modLFOToSync2 = interpModLFOToSync2.getValue();
-    noteInfo.gainEnvelopeCurve = interpGainEnvelopeCurve.getValue();
-    noteInfo.filterCutoff = interpFilterCutoff.getValue();
-    noteInfo.filterResonance = interpFilterResonance.getValue();
-    noteInfo.filterFeedback = interpFilterFeedback.getValue();
-    noteInfo.filterSaturation = interpFilterSaturation.getValue();
-    noteInfo.filterCutoffAmount = interpFilterCutoffAmount.getValue();
-    noteInfo.filterResonanceAmount = interpFilterResonanceAmount.getValue();
-    noteInfo.filterKeyToCutoff = interpFilterKeyToCutoff.getValue();
-    noteInfo.filterKeyToFeedback = interpFilterKeyToFeedback.getValue();
-
-    // Beware the negative overflow. mptStop is size_t.
-    mptStop = mptIndex - 1;
-    if (mptStop >= transitionBuffer.size()) mptStop += transitionBuffer.size();
-
-    for (size_t j = 0; j < transitionBuffer.size(); ++j) {
-      if (notes[i][0]->state == NoteState::rest) {
-        mptStop = mptIndex + j;
-        if (mptStop >= transitionBuffer.size()) mptStop -= transitionBuffer.size();
-        break;
-      }
-
-      float sample = notes[i][0]->process(noteInfo);
-      if (
-        param.value[ParameterID::unison]->getInt()
-        && notes[i][1]->state != NoteState::rest) {
-        sample += notes[i][1]->process(noteInfo);
-      }
-      transitionBuffer[(mptIndex + j) % transitionBuffer.size()]
-        += sample * (0.5 + 0.5 * cosf(pi * (float)j / transitionBuffer.size()));
+    // Ghost closest to the end of fade is overwritten when all ghosts are used.
+    size_t ghostIndex = 0;
+    for (size_t idx = 1; idx < nGhost; ++idx) {
+      if (ghostCounter[idx] < ghostCounter[ghostIndex]) ghostIndex = idx;
     }
+    *ghosts[ghostIndex][0] = *notes[i][0];
+    *ghosts[ghostIndex][1] = *notes[i][1];
+    ghostCounter[ghostIndex] = ghostFadeLength;
   }
 
   auto normalizedKey = float(pitch) / 127.0f;
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "envelope.hpp"
@@ -139,7 +140,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   void pushMidiNote(
     bool isNoteOn,
@@ -156,22 +157,17 @@ public:
     note.pitch = pitch;
     note.tuning = tuning;
     note.velocity = velocity;
-    midiNotes.push_back(note);
+    midiNotes.push(note);
   }
 
   void processMidiNote(uint32_t frame)
   {
-    while (true) {
-      auto it = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {
-        return nt.frame == frame;
-      });
-      if (it == std::end(midiNotes)) return;
-      if (it->isNoteOn)
-        noteOn(it->id, it->pitch, it->tuning, it->velocity);
+    midiNotes.dispatch(frame, [&](const MidiNote &nt) {
+      if (nt.isNoteOn)
+        noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);
       else
-        noteOff(it->id);
-      midiNotes.erase(it);
-    }
+        noteOff(nt.id);
+    });
   }
 
 private:
@@ -217,9 +213,10 @@ private:
   std::array<std::array<std::unique_ptr<Note<float>>, 2>, maxVoice> notes;
 
   // Transition happens when synth is playing all notes and user send a new note on.
-  // transitionBuffer is used to store a release of a note to reduce pop noise.
-  std::vector<float> transitionBuffer{};
-  bool isTransitioning = false;
-  size_t mptIndex = 0; // mpt for Max Poly Transition.
-  size_t mptStop = 0;
+  // Stolen note is copied to a ghost, and the ghost fades out to reduce pop noise.
+  // ghostCounter is the remaining length of fade. 0 means the ghost is free.
+  static const size_t nGhost = 4;
+  std::array<std::array<std::unique_ptr<Note<float>>, 2>, nGhost> ghosts;
+  std::array<size_t, nGhost> ghostCounter{};
+  size_t ghostFadeLength = 1;
 };
@@ -21,6 +21,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -416,10 +417,12 @@ struct GlobalParameter : public ParameterInterface {
     "ThisIsntAModem",
   };
 
+#ifndef TEST_BUILD
   void initProgramName(uint32_t index, String &programName)
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index);
 };
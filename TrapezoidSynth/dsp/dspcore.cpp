@@ -395,14 +395,17 @@ void DSPCore::process(
   SmootherCommon<float>::setBufferSize(length);
 
   float sample = 0;
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    sample = tpz1.process(hostFrame + i);
-    const float masterGain = interpMasterGain.process();
-    out0[i] = masterGain * sample;
-    out1[i] = masterGain * sample;
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      sample = tpz1.process(hostFrame + i);
+      const float masterGain = interpMasterGain.process();
+      out0[i] = masterGain * sample;
+      out1[i] = masterGain * sample;
+    }
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
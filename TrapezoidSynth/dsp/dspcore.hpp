@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "envelope.hpp"
@@ -132,8 +133,6 @@ public:
   static const size_t maxVoice = 32;
   GlobalParameter param;
 
-  DSPCore() { midiNotes.reserve(128); }
-
   void setup(double sampleRate);
   void free();    // Release memory.
   void reset();   // Stop sounds.
@@ -152,7 +151,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   void pushMidiNote(
     bool isNoteOn,
@@ -169,22 +168,17 @@ public:
     note.pitch = pitch;
     note.tuning = tuning;
     note.velocity = velocity;
-    midiNotes.push_back(note);
+    midiNotes.push(note);
   }
 
   void processMidiNote(uint32_t frame)
   {
-    while (true) {
-      auto it = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {
-        return nt.frame == frame;
-      });
-      if (it == std::end(midiNotes)) return;
-      if (it->isNoteOn)
-        noteOn(it->id, it->pitch, it->tuning, it->velocity);
+    midiNotes.dispatch(frame, [&](const MidiNote &nt) {
+      if (nt.isNoteOn)
+        noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);
       else
-        noteOff(it->id);
-      midiNotes.erase(it);
-    }
+        noteOff(nt.id);
+    });
   }
 
 private:
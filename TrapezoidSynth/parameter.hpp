@@ -20,6 +20,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <iostream>
 #include <memory>
 #include <vector>
@@ -457,10 +458,12 @@ struct GlobalParameter : public ParameterInterface {
     "TpzRoar",
   };
 
+#ifndef TEST_BUILD
   void initProgramName(uint32_t index, String &programName)
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index);
 
@@ -122,41 +122,44 @@ void DSPCore::process(
   const uint32_t oscType = param.value[ParameterID::oscType]->getInt();
 
   float sample;
-  for (size_t i = 0; i < length; ++i) {
+  for (uint32_t i = 0; i < length;) {
     processMidiNote(i);
 
-    const float pitch = interpPitch.process();
-    switch (oscType) {
-      case 0: // Off
-        sample = in0[i] + in1[i];
-        break;
-
-      case 2: // Sustain
-        pulsar.setFrequency(pitch);
-        // Fall through.
-
-      default:
-      case 1: // Impulse
-        sample = pulsar.process() + in0[i] + in1[i];
-        break;
-
-      case 3: // Velvet
-        sample = velvetNoise.process() + in0[i] + in1[i];
-        break;
-
-      case 4: // Brown
-        brownNoise.drift = 2 * pitch / sampleRate;
-        sample = brownNoise.process() + in0[i] + in1[i];
-        break;
+    for (const uint32_t end = midiNotes.nextFrame(length); i < end; ++i) {
+      const float pitch = interpPitch.process();
+      switch (oscType) {
+        case 0: // Off
+          sample = in0[i] + in1[i];
+          break;
+
+        case 2: // Sustain
+          pulsar.setFrequency(pitch);
+          // Fall through.
+
+        default:
+        case 1: // Impulse
+          sample = pulsar.process() + in0[i] + in1[i];
+          break;
+
+        case 3: // Velvet
+          sample = velvetNoise.process() + in0[i] + in1[i];
+          break;
+
+        case 4: // Brown
+          brownNoise.drift = 2 * pitch / sampleRate;
+          sample = brownNoise.process() + in0[i] + in1[i];
+          break;
+      }
+
+      if (excitation) sample = excitor.process(sample);
+      sample = cymbal.process(sample, collision);
+
+      const float masterGain = interpMasterGain.process();
+      out0[i] = masterGain * sample;
+      out1[i] = masterGain * sample;
     }
-
-    if (excitation) sample = excitor.process(sample);
-    sample = cymbal.process(sample, collision);
-
-    const float masterGain = interpMasterGain.process();
-    out0[i] = masterGain * sample;
-    out1[i] = masterGain * sample;
   }
+  processMidiNote(midiNotes.endOfBlock);
 }
 
 void DSPCore::noteOn(int32_t noteId, int16_t pitch, float tuning, float velocity)
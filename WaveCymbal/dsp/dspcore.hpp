@@ -18,6 +18,7 @@
 #pragma once
 
 #include "../../common/dsp/constants.hpp"
+#include "../../common/dsp/eventqueue.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../parameter.hpp"
 #include "ksstring.hpp"
@@ -58,7 +59,7 @@ public:
     float velocity;
   };
 
-  std::vector<MidiNote> midiNotes;
+  EventQueue<MidiNote, 1024> midiNotes;
 
   void pushMidiNote(
     bool isNoteOn,
@@ -75,22 +76,17 @@ public:
     note.pitch = pitch;
     note.tuning = tuning;
     note.velocity = velocity;
-    midiNotes.push_back(note);
+    midiNotes.push(note);
   }
 
   void processMidiNote(uint32_t frame)
   {
-    while (true) {
-      auto it = std::find_if(midiNotes.begin(), midiNotes.end(), [&](const MidiNote &nt) {
-        return nt.frame == frame;
-      });
-      if (it == std::end(midiNotes)) return;
-      if (it->isNoteOn)
-        noteOn(it->id, it->pitch, it->tuning, it->velocity);
+    midiNotes.dispatch(frame, [&](const MidiNote &nt) {
+      if (nt.isNoteOn)
+        noteOn(nt.id, nt.pitch, nt.tuning, nt.velocity);
       else
-        noteOff(it->id);
-      midiNotes.erase(it);
-    }
+        noteOff(nt.id);
+    });
   }
 
 private:
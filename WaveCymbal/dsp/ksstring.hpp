@@ -20,9 +20,10 @@
 #include <array>
 #include <memory>
 
+#include "../../common/dsp/delay.hpp"
 #include "../../common/dsp/smoother.hpp"
 #include "../../common/dsp/somemath.hpp"
-#include "delay.hpp"
+#include "../../lib/vcl/vectorclass.h"
 #include "wave.hpp"
 
 namespace SomeDSP {
@@ -119,7 +120,7 @@ protected:
   OneZeroLP<Sample> lowpass{0.5};
   RCHP<Sample> highpass{0.5};
   LinearSmoother<Sample> interpDelayTime;
-  Delay<Sample> delay;
+  OversampledDelay<Sample> delay;
 };
 
 template<typename Sample> class BiquadBandpass {
@@ -212,10 +213,10 @@ public:
 
 enum class CrossoverType { log, linear };
 
+// Wave is owned by WaveHat, which steps waves of all cymbals at once.
 template<typename Sample, size_t maxStack> class WaveString {
 public:
   size_t stack = 24;
-  Wave1D<Sample, maxStack> wave1d;
 
   std::array<Sample, maxStack> stringRnd{};
   std::array<KSString<Sample>, maxStack> string;
@@ -225,7 +226,6 @@ public:
 
   void setup(Sample sampleRate)
   {
-    wave1d.setup(sampleRate, maxStack, 0.5, 0.5, 0.1);
     for (auto &str : string) str.setup(sampleRate, Sample(100.0), Sample(0.5));
     for (auto &bp : bandpass) bp.setup(sampleRate);
     stringRnd.fill(1);
@@ -242,9 +242,6 @@ public:
     size_t stack,
     Sample minFrequency,
     Sample maxFrequency,
-    Sample damping,
-    Sample pulsePosition,
-    Sample pulseWidth,
     Sample decay,
     Sample bandpassQ,
     CrossoverType crossoverType,
@@ -252,8 +249,6 @@ public:
   {
     this->stack = stack < maxStack ? stack : maxStack;
 
-    wave1d.set(this->stack, damping, pulsePosition, pulseWidth);
-
     Sample low = 20;
     Sample high = 20;
     for (size_t i = 0; i < this->stack; ++i) {
@@ -269,7 +264,6 @@ public:
 
   void reset()
   {
-    wave1d.reset();
     for (auto &str : string) str.reset();
     for (auto &bp : bandpass) bp.reset();
   }
@@ -283,31 +277,38 @@ public:
         somelog<Sample>(high / low) * index / length + somelog<Sample>(low));
   }
 
-  Sample process(Sample input)
+  // Reads and writes `lane` of `wave`. Call after `wave` is stepped.
+  template<typename Wave> Sample process(Wave &wave, int lane)
   {
-    wave1d.process(input);
     Sample output = 0;
     Sample denom = stack * 1024;
     for (size_t i = 0; i < stack; ++i) {
-      const auto rendered = string[i].process(bandpass[i].process(wave1d[i]));
-      wave1d[i] += rendered / denom;
+      auto &point = wave[i];
+      const auto rendered = string[i].process(bandpass[i].process(point[lane]));
+      point.insert(lane, point[lane] + rendered / denom);
       output += rendered;
     }
     return output;
   }
 };
 
+/**
+Waves of all cymbals are stepped at once in `wave`. Lane `i` of a point is the wave of
+cymbal `i`. Lanes from `nCymbal` to 3 are stepped, but not used.
+*/
 template<typename Sample> class WaveHat {
 public:
   static const size_t maxStack = 64;
-  static const size_t maxCymbal = 4;
+  static const size_t maxCymbal = 4; // Number of lanes in Vec4f.
 
   size_t nCymbal = 0;
   Sample distance = 100;
+  Wave1D<Sample, maxStack, Vec4f> wave;
   std::array<WaveString<Sample, maxStack>, maxCymbal> string;
 
   void setup(Sample sampleRate)
   {
+    wave.setup(sampleRate, maxStack, 0.5, 0.5, 0.1);
     for (auto &str : string) str.setup(sampleRate);
   }
 
@@ -333,35 +334,41 @@ public:
     this->nCymbal = nCymbal > maxCymbal ? maxCymbal : nCymbal;
     this->distance = distance;
 
+    wave.set(stack, damping, pulsePosition, pulseWidth);
     for (size_t i = 0; i < nCymbal; ++i) {
       string[i].set(
-        stack, minFrequency, maxFrequency, damping, pulsePosition, pulseWidth, decay,
-        bandpassQ, crossoverType, randomAmount);
+        stack, minFrequency, maxFrequency, decay, bandpassQ, crossoverType,
+        randomAmount);
     }
   }
 
   void reset()
   {
+    wave.reset();
     for (auto &str : string) str.reset();
   }
 
-  void collide(Wave1D<Sample, maxStack> &w1, Wave1D<Sample, maxStack> &w2)
+  // Cymbal `i` collides with cymbal `i + 1`. Every pair reads the waves before collision,
+  // so all pairs are processed at once.
+  void collide()
   {
-    for (size_t i = 0; i < w1.length; ++i) {
-      const auto intersection = w1[i] - w2[i] + distance / Sample(1024);
-      if (intersection < 0) w1[i] = -w1[i];
+    const Vec4fb isLeft = Vec4f(0, 1, 2, 3) < float(nCymbal - 1);
+    const Sample offset = distance / Sample(1024);
+    for (size_t i = 0; i < wave.length; ++i) {
+      const Vec4f point = wave[i];
+      const Vec4f intersection = point - permute4<1, 2, 3, -1>(point) + offset;
+      wave[i] = select(isLeft & (intersection < 0), -point, point);
     }
   }
 
   Sample process(Sample input, bool collision = true)
   {
+    wave.process(input);
+
     Sample output = 0;
-    for (size_t i = 0; i < nCymbal; ++i) output += string[i].process(input);
+    for (size_t i = 0; i < nCymbal; ++i) output += string[i].process(wave, int(i));
 
-    if (collision) {
-      size_t end = nCymbal - 1;
-      for (size_t i = 0; i < end; ++i) collide(string[i].wave1d, string[i + 1].wave1d);
-    }
+    if (collision) collide();
 
     return output / nCymbal;
   }
@@ -406,7 +413,7 @@ protected:
   Sample gain = 0;
   Sample feedback = 0;
   LinearSmoother<Sample> interpDelayTime;
-  Delay<Sample> delay;
+  OversampledDelay<Sample> delay;
 };
 
 template<typename Sample> class Excitor {
@@ -24,7 +24,16 @@
 
 namespace SomeDSP {
 
-template<typename Sample, size_t maxLength> class Wave1D {
+/**
+1D wave equation with periodic boundary. `Frame` is the type of a point, which is
+`Sample` or a SIMD vector to step several waves of the same length at once.
+
+Three time steps are kept in `buffer`, and rotated by changing `front` instead of
+copying. Each buffer has a ghost cell on both sides of the wave. They are filled by the
+other end before step, so the stencil runs without branch on the boundary. The right
+ghost is at `length`, which overwrites a point out of the current wave.
+*/
+template<typename Sample, size_t maxLength, typename Frame = Sample> class Wave1D {
 public:
   size_t length = 1;
 
@@ -64,40 +73,37 @@ public:
 
   void step()
   {
-    auto tmp = wave2;
-    wave2 = wave1;
-    wave1 = wave0;
-    wave0 = tmp;
+    front = front == 0 ? 2 : front - 1;
 
-    size_t end = length - 1;
+    // Index is shifted by 1 for the left ghost.
+    Frame *wave0 = buffer[front].data() + 1;
+    Frame *wave1 = buffer[front == 2 ? 0 : front + 1].data();
+    const Frame *wave2 = buffer[front == 0 ? 2 : front - 1].data() + 1;
 
-    wave0[0] = damping * (alpha * (wave1[end] + wave1[1]) + beta * wave1[0] - wave2[0]);
+    wave1[0] = wave1[length];
+    wave1[length + 1] = wave1[1];
 
-    for (size_t i = 1; i < end; ++i) {
+    for (size_t i = 0; i < length; ++i) {
       wave0[i]
-        = damping * (alpha * (wave1[i - 1] + wave1[i + 1]) + beta * wave1[i] - wave2[i]);
+        = damping * (alpha * (wave1[i] + wave1[i + 2]) + beta * wave1[i + 1] - wave2[i]);
     }
-
-    wave0[end]
-      = damping * (alpha * (wave1[end - 1] + wave1[0]) + beta * wave1[end] - wave2[end]);
   }
 
   void reset()
   {
-    wave0.fill(0);
-    wave1.fill(0);
-    wave2.fill(0);
+    for (auto &buf : buffer) buf.fill(Frame(0));
+    front = 0;
   }
 
-  Sample at(size_t index)
+  Frame at(size_t index)
   {
-    if (index < 0) return 0;
-    if (index >= length) return 0;
-    return wave0[index];
+    if (index < 0) return Frame(0);
+    if (index >= length) return Frame(0);
+    return buffer[front][index + 1];
   }
 
   // Unsafe fast lookup.
-  Sample &operator[](const size_t index) { return wave0[index]; }
+  Frame &operator[](const size_t index) { return buffer[front][index + 1]; }
 
   void pulse(Sample height)
   {
@@ -108,7 +114,7 @@ public:
     auto twoPi_N1 = Sample(twopi) / (pulseWidth - 1);
     height /= pulseWidth * Sample(0.5);
     for (size_t i = 0; i < pulseWidth; ++i) {
-      wave0[index] += height
+      (*this)[index] += height
         * (Sample(1.0)
            - juce::dsp::FastMathApproximations::cos<Sample>(twoPi_N1 * i - Sample(pi)));
       index += 1;
@@ -132,9 +138,8 @@ protected:
   size_t pulseWidth = 0;
   size_t pulsePosition = 0;
 
-  std::array<Sample, maxLength> wave0{};
-  std::array<Sample, maxLength> wave1{};
-  std::array<Sample, maxLength> wave2{};
+  size_t front = 0; // Index of the latest step in `buffer`.
+  std::array<std::array<Frame, maxLength + 2>, 3> buffer;
 };
 
 } // namespace SomeDSP
@@ -20,6 +20,7 @@
 #include "../common/parameterinterface.hpp"
 #include "../common/value.hpp"
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -238,10 +239,12 @@ struct GlobalParameter : public ParameterInterface {
     "Why",
   };
 
+#ifndef TEST_BUILD
   void initProgramName(uint32_t index, String &programName)
   {
     programName = this->programName[index];
   }
+#endif
 
   void loadProgram(uint32_t index);
 };
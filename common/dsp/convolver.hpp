@@ -0,0 +1,419 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "../../lib/fftw3/fftw3.h"
+
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <mutex>
+#include <vector>
+
+namespace SomeDSP {
+
+/**
+Real FFT of fixed size. `forward` and `inverse` can be called from any thread, because
+executing a plan on new arrays is thread safe in FFTW. Only planner is serialized.
+
+`inverse` isn't normalized, and destroys `spectrum`.
+*/
+class RealFFT {
+public:
+  const size_t size;
+
+  RealFFT(size_t size) : size(size)
+  {
+    std::vector<float> time(size);
+    std::vector<std::complex<float>> spectrum(size / 2 + 1);
+
+    std::lock_guard<std::mutex> lock(plannerMutex());
+    r2c = fftwf_plan_dft_r2c_1d(
+      int(size), time.data(), toFFTW(spectrum.data()), FFTW_ESTIMATE | FFTW_UNALIGNED);
+    c2r = fftwf_plan_dft_c2r_1d(
+      int(size), toFFTW(spectrum.data()), time.data(), FFTW_ESTIMATE | FFTW_UNALIGNED);
+  }
+
+  ~RealFFT()
+  {
+    std::lock_guard<std::mutex> lock(plannerMutex());
+    fftwf_destroy_plan(r2c);
+    fftwf_destroy_plan(c2r);
+  }
+
+  RealFFT(const RealFFT &) = delete;
+  RealFFT &operator=(const RealFFT &) = delete;
+
+  void forward(float *time, std::complex<float> *spectrum) const
+  {
+    fftwf_execute_dft_r2c(r2c, time, toFFTW(spectrum));
+  }
+
+  void inverse(std::complex<float> *spectrum, float *time) const
+  {
+    fftwf_execute_dft_c2r(c2r, toFFTW(spectrum), time);
+  }
+
+private:
+  static std::mutex &plannerMutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static fftwf_complex *toFFTW(std::complex<float> *data)
+  {
+    return reinterpret_cast<fftwf_complex *>(data);
+  }
+
+  fftwf_plan r2c;
+  fftwf_plan c2r;
+};
+
+/**
+Zero latency convolution of 2 inputs and 2 outputs. Path from input `i` to output `o` has
+index `2 * i + o`.
+
+Impulse response is split into 3 segments:
+
+- Taps from 0 to `headLength - 1` are convolved in direct form.
+- Taps up to `blockSize2 - 1` are convolved by uniformly partitioned overlap-save with
+  `blockSize1`.
+- Rest of taps are convolved by uniformly partitioned overlap-save with `blockSize2`.
+
+Overlap-save with block size `B` has `B` samples of latency, and its segment starts at tap
+`B`. So output of each segment lines up without delay.
+
+`makeImpulse` transforms impulse response into spectra of partitions. It's slow and
+allocates memory, so call it off the audio thread. `process` only runs FFT when a block
+is filled. Multiply-add of `blockSize2` partitions which only use past input is spread
+over `blockSize2 / blockSize1` steps, so that the peak cost stays close to the one of
+`blockSize1`.
+*/
+class StereoConvolver {
+public:
+  static constexpr size_t headLength = 64;
+  static constexpr size_t blockSize1 = 64;
+  static constexpr size_t blockSize2 = 1024;
+  static constexpr size_t nPartition1 = blockSize2 / blockSize1 - 1;
+  static constexpr size_t maxPartition2 = 255;
+  static constexpr size_t maxLength = blockSize2 * (maxPartition2 + 1);
+
+  // Spectra of partitions stored as separate real and imaginary part, so that complex
+  // multiplication runs on SIMD. Index is `(path * nPartition + partition) * nBin + bin`.
+  struct Spectra {
+    size_t nPartition = 0;
+    std::vector<float> re;
+    std::vector<float> im;
+  };
+
+  // Impulse response of each path.
+  using Response = std::array<std::vector<float>, 4>;
+
+  struct Impulse {
+    size_t length = 0;
+    std::array<std::array<float, headLength>, 4> head{}; // Reversed.
+    Spectra spectra1;
+    Spectra spectra2;
+  };
+
+  StereoConvolver() : fft1(2 * blockSize1), fft2(2 * blockSize2) {}
+
+  void setup()
+  {
+    level1.setup(blockSize1, nPartition1, 1);
+    level2.setup(blockSize2, maxPartition2, blockSize2 / blockSize1);
+    reset();
+  }
+
+  void reset()
+  {
+    for (auto &hst : history) hst.fill(0);
+    wptr = 0;
+    level1.reset();
+    level2.reset();
+  }
+
+  // `response` must have the same length for all paths, up to `maxLength`.
+  void makeImpulse(Impulse &impulse, const Response &response) const
+  {
+    const size_t length = response[0].size();
+    impulse.length = length;
+
+    for (size_t path = 0; path < response.size(); ++path) {
+      auto &head = impulse.head[path];
+      for (size_t i = 0; i < headLength; ++i)
+        head[headLength - 1 - i] = i < length ? response[path][i] : 0.0f;
+    }
+
+    makeSpectra(impulse.spectra1, response, fft1, blockSize1, nPartition1);
+
+    const size_t nPartition2 = length > blockSize2
+      ? std::min((length - 1) / blockSize2, maxPartition2)
+      : 0;
+    makeSpectra(impulse.spectra2, response, fft2, blockSize2, nPartition2);
+  }
+
+  // Number of samples until output becomes 0 after input stopped. After that, `process`
+  // can be skipped while input is 0.
+  size_t flushLength(const Impulse &impulse) const
+  {
+    return std::max(headLength, (impulse.spectra2.nPartition + 2) * blockSize2);
+  }
+
+  // Call before resuming `process` after `flushLength` samples of silence. Ring buffers
+  // may still have spectra older than the silence, and they are ignored until
+  // overwritten. It's cheaper than `reset` which clears all the buffers.
+  void restart()
+  {
+    level1.restart();
+    level2.restart();
+  }
+
+  std::array<float, 2> process(float in0, float in1, const Impulse &impulse)
+  {
+    history[0][wptr] = history[0][wptr + headLength] = in0;
+    history[1][wptr] = history[1][wptr + headLength] = in1;
+    if (++wptr >= headLength) wptr = 0;
+
+    const float *hst0 = history[0].data() + wptr;
+    const float *hst1 = history[1].data() + wptr;
+    std::array<float, 2> out{};
+    for (size_t i = 0; i < headLength; ++i) {
+      out[0] += impulse.head[0][i] * hst0[i] + impulse.head[2][i] * hst1[i];
+      out[1] += impulse.head[1][i] * hst0[i] + impulse.head[3][i] * hst1[i];
+    }
+
+    auto out1 = level1.process(in0, in1, impulse.spectra1, fft1);
+    auto out2 = level2.process(in0, in1, impulse.spectra2, fft2);
+    out[0] += out1[0] + out2[0];
+    out[1] += out1[1] + out2[1];
+    return out;
+  }
+
+private:
+  // Writes spectra of taps from `blockSize` to `blockSize * (nPartition + 1) - 1`.
+  static void makeSpectra(
+    Spectra &spectra,
+    const Response &response,
+    const RealFFT &fft,
+    size_t blockSize,
+    size_t nPartition)
+  {
+    const size_t nBin = blockSize + 1;
+    spectra.nPartition = nPartition;
+    spectra.re.resize(response.size() * nPartition * nBin);
+    spectra.im.resize(response.size() * nPartition * nBin);
+
+    // Normalization of inverse FFT is applied here.
+    const float scale = 1.0f / float(fft.size);
+
+    std::vector<float> time(fft.size);
+    std::vector<std::complex<float>> spectrum(nBin);
+    for (size_t path = 0; path < response.size(); ++path) {
+      const auto &rsp = response[path];
+      for (size_t part = 0; part < nPartition; ++part) {
+        const size_t start = blockSize * (part + 1);
+        std::fill(time.begin(), time.end(), 0.0f);
+        for (size_t i = 0; i < blockSize && start + i < rsp.size(); ++i)
+          time[i] = scale * rsp[start + i];
+        fft.forward(time.data(), spectrum.data());
+
+        const size_t offset = (path * nPartition + part) * nBin;
+        for (size_t bin = 0; bin < nBin; ++bin) {
+          spectra.re[offset + bin] = spectrum[bin].real();
+          spectra.im[offset + bin] = spectrum[bin].imag();
+        }
+      }
+    }
+  }
+
+  // Uniformly partitioned overlap-save. Spectra of past input blocks are kept in a ring
+  // buffer of `capacity` partitions, so it can be used with any number of partitions up
+  // to the capacity. `filled` is the number of slots written after `reset` or `restart`.
+  //
+  // Only partition 0 needs the block which is being filled. Other partitions are
+  // accumulated in `nStep` steps, one at every `blockSize / nStep` samples. The last step
+  // runs at the end of block together with FFT. `done` is the number of partitions
+  // accumulated for the next block.
+  class Level {
+  public:
+    void setup(size_t blockSize, size_t capacity, size_t nStep)
+    {
+      this->blockSize = blockSize;
+      this->capacity = capacity;
+      this->nStep = nStep;
+      stepLength = blockSize / nStep;
+      nBin = blockSize + 1;
+
+      for (size_t ch = 0; ch < 2; ++ch) {
+        window[ch].resize(2 * blockSize);
+        output[ch].resize(blockSize);
+        inputRe[ch].resize(capacity * nBin);
+        inputIm[ch].resize(capacity * nBin);
+        accRe[ch].resize(nBin);
+        accIm[ch].resize(nBin);
+      }
+      spectrum.resize(nBin);
+      time.resize(2 * blockSize);
+    }
+
+    void reset()
+    {
+      for (size_t ch = 0; ch < 2; ++ch) {
+        std::fill(window[ch].begin(), window[ch].end(), 0.0f);
+        std::fill(output[ch].begin(), output[ch].end(), 0.0f);
+        std::fill(inputRe[ch].begin(), inputRe[ch].end(), 0.0f);
+        std::fill(inputIm[ch].begin(), inputIm[ch].end(), 0.0f);
+      }
+      pos = 0;
+      nextStep = stepLength;
+      newest = 0;
+      restart();
+    }
+
+    void restart()
+    {
+      filled = 0;
+      done = 1;
+      for (size_t ch = 0; ch < 2; ++ch) {
+        std::fill(accRe[ch].begin(), accRe[ch].end(), 0.0f);
+        std::fill(accIm[ch].begin(), accIm[ch].end(), 0.0f);
+      }
+    }
+
+    std::array<float, 2> process(
+      float in0, float in1, const Spectra &spectra, const RealFFT &fft)
+    {
+      if (spectra.nPartition == 0) return {0.0f, 0.0f};
+
+      window[0][blockSize + pos] = in0;
+      window[1][blockSize + pos] = in1;
+      std::array<float, 2> out{output[0][pos], output[1][pos]};
+      if (++pos >= blockSize) {
+        pos = 0;
+        nextStep = stepLength;
+        processBlock(spectra, fft);
+      } else if (pos == nextStep) {
+        nextStep += stepLength;
+        processStep(spectra, pos / stepLength);
+      }
+      return out;
+    }
+
+  private:
+    // Spectrum of the block being filled goes to `upcoming` slot. Partition `part` of
+    // the next output uses the slot at `upcoming + part`.
+    size_t upcomingSlot() const { return newest == 0 ? capacity - 1 : newest - 1; }
+
+    void processStep(const Spectra &spectra, size_t step)
+    {
+      const size_t nUsed = std::min(spectra.nPartition, filled + 1);
+      if (nUsed <= 1) return;
+      const size_t last = 1 + (nUsed - 1) * step / nStep;
+      if (done >= last) return;
+      multiplyAdd(spectra, upcomingSlot(), done, last);
+      done = last;
+    }
+
+    void multiplyAdd(const Spectra &spectra, size_t head, size_t first, size_t last)
+    {
+      const size_t nPartition = spectra.nPartition;
+      for (size_t out = 0; out < 2; ++out) {
+        float *aRe = accRe[out].data();
+        float *aIm = accIm[out].data();
+        for (size_t in = 0; in < 2; ++in) {
+          const size_t path = 2 * in + out;
+          for (size_t part = first; part < last; ++part) {
+            const size_t slot = (head + part) % capacity;
+            const float *xRe = inputRe[in].data() + slot * nBin;
+            const float *xIm = inputIm[in].data() + slot * nBin;
+            const float *hRe = spectra.re.data() + (path * nPartition + part) * nBin;
+            const float *hIm = spectra.im.data() + (path * nPartition + part) * nBin;
+            for (size_t bin = 0; bin < nBin; ++bin) {
+              aRe[bin] += xRe[bin] * hRe[bin] - xIm[bin] * hIm[bin];
+              aIm[bin] += xRe[bin] * hIm[bin] + xIm[bin] * hRe[bin];
+            }
+          }
+        }
+      }
+    }
+
+    void processBlock(const Spectra &spectra, const RealFFT &fft)
+    {
+      newest = upcomingSlot();
+      if (filled < capacity) ++filled;
+
+      for (size_t ch = 0; ch < 2; ++ch) {
+        fft.forward(window[ch].data(), spectrum.data());
+        float *re = inputRe[ch].data() + newest * nBin;
+        float *im = inputIm[ch].data() + newest * nBin;
+        for (size_t bin = 0; bin < nBin; ++bin) {
+          re[bin] = spectrum[bin].real();
+          im[bin] = spectrum[bin].imag();
+        }
+        std::copy(window[ch].begin() + blockSize, window[ch].end(), window[ch].begin());
+      }
+
+      // `done` may exceed `nUsed` when `spectra` is replaced during a block.
+      const size_t nUsed = std::min(spectra.nPartition, filled);
+      multiplyAdd(spectra, newest, 0, 1);
+      if (done < nUsed) multiplyAdd(spectra, newest, done, nUsed);
+      done = 1;
+
+      for (size_t out = 0; out < 2; ++out) {
+        for (size_t bin = 0; bin < nBin; ++bin)
+          spectrum[bin] = std::complex<float>(accRe[out][bin], accIm[out][bin]);
+        fft.inverse(spectrum.data(), time.data());
+        std::copy(time.begin() + blockSize, time.end(), output[out].begin());
+        std::fill(accRe[out].begin(), accRe[out].end(), 0.0f);
+        std::fill(accIm[out].begin(), accIm[out].end(), 0.0f);
+      }
+    }
+
+    size_t blockSize = 1;
+    size_t capacity = 1;
+    size_t nStep = 1;
+    size_t stepLength = 1;
+    size_t nBin = 2;
+    size_t pos = 0;
+    size_t nextStep = 1;
+    size_t newest = 0; // Slot of the latest input spectrum.
+    size_t filled = 0;
+    size_t done = 1;
+
+    std::array<std::vector<float>, 2> window;
+    std::array<std::vector<float>, 2> output;
+    std::array<std::vector<float>, 2> inputRe;
+    std::array<std::vector<float>, 2> inputIm;
+    std::array<std::vector<float>, 2> accRe;
+    std::array<std::vector<float>, 2> accIm;
+    std::vector<std::complex<float>> spectrum;
+    std::vector<float> time;
+  };
+
+  RealFFT fft1;
+  RealFFT fft2;
+
+  std::array<std::array<float, 2 * headLength>, 2> history{};
+  size_t wptr = 0;
+  Level level1;
+  Level level2;
+};
+
+} // namespace SomeDSP
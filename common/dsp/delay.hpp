@@ -0,0 +1,215 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace SomeDSP {
+
+/**
+Weights of Lagrange interpolation for fractional delay. Order is odd, so that the read
+position stays between 2 taps at the center, where the error is smallest. Read position
+is `fraction` in [0, 1) samples older than the tap at `nNewer`, counted from the newest.
+
+Weight of tap `k`, counted from the newest, is `prod_{j != k} (u - j) / (k - j)` where `u`
+is the read position. Numerators are computed from prefix and suffix products, and
+reciprocals of denominators are constant.
+*/
+template<size_t order> struct LagrangeInterp {
+  static_assert(order % 2 == 1, "Order must be odd.");
+
+  static constexpr size_t nTap = order + 1;
+  static constexpr size_t nNewer = (order - 1) / 2;
+
+  // Returns weights of taps, oldest first. For polyphase filters which precompute them.
+  template<typename Sample> static std::array<Sample, nTap> coefficient(Sample fraction)
+  {
+    const Sample u = Sample(nNewer) + fraction;
+
+    std::array<Sample, nTap> prefix;
+    std::array<Sample, nTap> suffix;
+    prefix[0] = Sample(1);
+    suffix[nTap - 1] = Sample(1);
+    for (size_t k = 1; k < nTap; ++k) {
+      prefix[k] = prefix[k - 1] * (u - Sample(k - 1));
+      suffix[nTap - 1 - k] = suffix[nTap - k] * (u - Sample(nTap - k));
+    }
+
+    std::array<Sample, nTap> weight;
+    for (size_t k = 0; k < nTap; ++k)
+      weight[nTap - 1 - k] = Sample(inverseDenominator[k]) * prefix[k] * suffix[k];
+    return weight;
+  }
+
+private:
+  static constexpr std::array<double, nTap> reciprocalOfDenominator()
+  {
+    std::array<double, nTap> value{};
+    for (size_t k = 0; k < nTap; ++k) {
+      double prod = 1;
+      for (size_t j = 0; j < nTap; ++j)
+        if (j != k) prod *= double(k) - double(j);
+      value[k] = 1 / prod;
+    }
+    return value;
+  }
+
+  static constexpr auto inverseDenominator = reciprocalOfDenominator();
+};
+
+/**
+Ring buffer of power of 2 length. Index wraps by mask instead of branch.
+*/
+template<typename Sample> class RingBuffer {
+public:
+  // Allocates at least `minSize` samples. Content is kept when size doesn't change.
+  void setup(size_t minSize)
+  {
+    size_t newSize = 1;
+    while (newSize < minSize) newSize *= 2;
+    if (newSize == size) return;
+
+    size = newSize;
+    mask = size - 1;
+    buf.assign(size, Sample(0));
+    wptr = 0;
+  }
+
+  void reset()
+  {
+    std::fill(buf.begin(), buf.end(), Sample(0));
+    wptr = 0;
+  }
+
+  size_t getSize() const { return size; }
+
+  inline void push(Sample value)
+  {
+    buf[wptr] = value;
+    wptr = (wptr + 1) & mask;
+  }
+
+  void write(const Sample *data, size_t length)
+  {
+    while (length > 0) {
+      const size_t count = std::min(length, size - wptr);
+      std::copy_n(data, count, buf.begin() + wptr);
+      wptr = (wptr + count) & mask;
+      data += count;
+      length -= count;
+    }
+  }
+
+  // Returns the sample pushed `delay` samples before the latest.
+  inline Sample at(size_t delay) const { return buf[(wptr - 1 - delay) & mask]; }
+
+private:
+  size_t size = 0;
+  size_t mask = 0;
+  size_t wptr = 0;
+  std::vector<Sample> buf;
+};
+
+/**
+Midpoints of 2x upsampling by linear interpolation. `at(input, w1)` returns the sample
+between the current `input` and the previous one `w1`. They are equal in exact arithmetic,
+but rounding differs, so each plugin keeps the formula its old copy of `Delay` used.
+*/
+struct DifferenceMidpoint {
+  template<typename Sample> static inline Sample at(Sample input, Sample w1)
+  {
+    return input - Sample(0.5) * (input - w1);
+  }
+};
+
+struct AverageMidpoint {
+  template<typename Sample> static inline Sample at(Sample input, Sample w1)
+  {
+    return Sample(0.5) * (input + w1);
+  }
+};
+
+/**
+2x oversampled delay. Input is upsampled by linear interpolation, and output is read
+with linear interpolation at the oversampled rate. This used to be copied as `Delay` in
+FDNCymbal, IterativeSinCluster, LightPadSynth and WaveCymbal with DifferenceMidpoint, and
+in LatticeReverb with AverageMidpoint. The output is the same as those.
+
+Delay time is kept until next `setTime`, and clamped to `length`, which is `maxTime` in
+oversampled samples plus 1. Taps wrap around at `length` like the ring buffer of the old
+`Delay`, so a tap at the maximum reads the latest input. Some presets reach the maximum
+and depend on this.
+*/
+template<typename Sample, typename Midpoint = DifferenceMidpoint>
+class OversampledDelay {
+public:
+  void setup(Sample sampleRate, Sample time, Sample maxTime)
+  {
+    this->sampleRate = Sample(2) * sampleRate;
+
+    length = size_t(this->sampleRate * maxTime) + 1;
+    ring.setup(length);
+
+    setTime(time);
+    reset();
+  }
+
+  // Returns oversampled sample rate.
+  Sample getSampleRate() const { return sampleRate; }
+
+  void setTime(Sample seconds)
+  {
+    const Sample timeInSample
+      = std::clamp<Sample>(sampleRate * seconds, 0, Sample(length));
+    const size_t timeInt = size_t(timeInSample);
+    rFraction = timeInSample - Sample(timeInt);
+
+    newer = timeInt >= length ? timeInt - length : timeInt;
+    older = newer + 1 >= length ? newer + 1 - length : newer + 1;
+  }
+
+  void reset()
+  {
+    ring.reset();
+    w1 = 0;
+  }
+
+  Sample process(Sample input)
+  {
+    ring.push(Midpoint::at(input, w1));
+    ring.push(input);
+    w1 = input;
+
+    const Sample x0 = ring.at(newer);
+    return x0 - rFraction * (x0 - ring.at(older));
+  }
+
+private:
+  Sample sampleRate = 44100;
+  Sample rFraction = 0;
+  Sample w1 = 0;
+  size_t length = 1;
+  size_t newer = 0; // Delay of taps in oversampled samples.
+  size_t older = 0;
+  RingBuffer<Sample> ring;
+};
+
+} // namespace SomeDSP
@@ -0,0 +1,93 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace SomeDSP {
+
+/**
+Fixed capacity queue of events sorted by `Event::frame`. Events on the same frame are
+kept in pushed order. Nothing is allocated after construction, so it's safe to use on
+audio thread.
+
+`push` drops the event and returns false when the queue is full.
+
+Typical usage in `process`. Inner loop doesn't have to check events:
+
+```
+for (uint32_t i = 0; i < length;) {
+  queue.dispatch(i, handler);
+  for (const uint32_t end = queue.nextFrame(length); i < end; ++i) {
+    // Process a sample.
+  }
+}
+queue.dispatch(queue.endOfBlock, handler);
+```
+
+The last `dispatch` applies events at or after `length` at the end of block.
+*/
+template<typename Event, size_t capacity> class EventQueue {
+public:
+  static constexpr uint32_t endOfBlock = std::numeric_limits<uint32_t>::max();
+
+  bool empty() const { return first == last; }
+  size_t size() const { return last - first; }
+  void clear() { first = last = 0; }
+
+  bool push(const Event &event)
+  {
+    if (last >= capacity) {
+      if (first == 0) return false;
+      std::move(buffer.begin() + first, buffer.begin() + last, buffer.begin());
+      last -= first;
+      first = 0;
+    }
+
+    // Events usually come in order, so this loop rarely runs.
+    size_t index = last++;
+    for (; index > first && buffer[index - 1].frame > event.frame; --index)
+      buffer[index] = buffer[index - 1];
+    buffer[index] = event;
+    return true;
+  }
+
+  // Returns the frame of next event. Returns `length` if there's no event before it.
+  uint32_t nextFrame(uint32_t length) const
+  {
+    if (empty()) return length;
+    return std::min<uint32_t>(buffer[first].frame, length);
+  }
+
+  // Calls `func(event)` for each event on or before `frame`, and removes them.
+  template<typename Func> void dispatch(uint32_t frame, Func func)
+  {
+    while (first < last && buffer[first].frame <= frame) func(buffer[first++]);
+    if (first == last) clear();
+  }
+
+private:
+  std::array<Event, capacity> buffer{};
+  size_t first = 0;
+  size_t last = 0;
+};
+
+} // namespace SomeDSP
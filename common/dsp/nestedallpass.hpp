@@ -0,0 +1,240 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SomeDSP {
+
+/**
+Pointers to smoothed parameters of all nested allpasses. A nest at depth `d` with index
+`k` reads `nest` values from `feed[d - 1] + k * nest`, and its children have indices from
+`k * nest` to `k * nest + nest - 1`. Depth 1 also reads `seconds` and `innerFeed` at the
+same offset.
+*/
+template<typename Sample> struct NestParameter {
+  const Sample *seconds;
+  const Sample *innerFeed;
+  std::array<const Sample *, 4> feed;
+};
+
+/**
+Nested allpass used in L3Reverb and L4Reverb, with flattened state.
+
+`nSection` is the number of sections in a nest, from depth 1 to the top. Sections of
+depth 1 are allpasses with 2x oversampled delay, and sections of other depths are nests
+of one depth lower. Parameters are indexed as described in NestParameter.
+
+`in` and `buffer` of all nests are stored in a single array, and all delay buffers are
+allocated from a single arena. Allpasses of depth 1 are placed in the order of
+traversal, which is the reverse of parameter index. The tree is traversed by a loop
+with a stack of section indices instead of recursion.
+
+Output is the same as recursive implementation like `NestD4` in L4Reverb.
+*/
+template<typename Sample, uint16_t... nSection> class FlatNestedAllpass {
+public:
+  static constexpr size_t nDepth = sizeof...(nSection);
+  static constexpr std::array<size_t, nDepth> section{nSection...};
+  static constexpr size_t nLeaf = (size_t(nSection) * ...);
+
+  static_assert(nDepth >= 1 && nDepth <= 4, "NestParameter has 4 depths.");
+
+  FlatNestedAllpass()
+  {
+    size_t count = 1;
+    size_t total = 0;
+    for (size_t depth = nDepth - 1; depth < nDepth; --depth) {
+      count *= section[depth];
+      nodeOffset[depth] = total;
+      total += count;
+    }
+    node.resize(total);
+    leaf.resize(count);
+  }
+
+  void setup(Sample sampleRate, Sample maxTime)
+  {
+    size = int(Sample(2) * sampleRate * maxTime) + 1;
+    if (size < 4) size = 4;
+
+    // Write pointers of all allpasses move together. Odd number of cache lines between
+    // buffers spreads them over cache sets.
+    constexpr size_t lineSize = 64 / sizeof(Sample);
+    stride = (size_t(size) + lineSize - 1) / lineSize;
+    if (stride % 2 == 0) ++stride;
+    stride *= lineSize;
+
+    arena.resize(stride * leaf.size());
+
+    reset();
+  }
+
+  void reset()
+  {
+    std::fill(node.begin(), node.end(), Node{});
+    std::fill(leaf.begin(), leaf.end(), Leaf{});
+    std::fill(arena.begin(), arena.end(), Sample(0));
+  }
+
+  // All allpasses are in series. Sum of their delay times is the time for a sample to
+  // pass through the nest without feedback.
+  static Sample pathTime(const NestParameter<Sample> &prm)
+  {
+    Sample sum = 0;
+    for (size_t idx = 0; idx < nLeaf; ++idx) sum += prm.seconds[idx];
+    return sum;
+  }
+
+  // Largest magnitude in the state which is read by later `process` calls, while `prm`
+  // stays the same. Output after input stopped only comes from this state, so a small
+  // value tells the end of response even when the output is temporarily quiet. Cost is
+  // proportional to `pathTime`.
+  Sample peakState(Sample sampleRate, const NestParameter<Sample> &prm) const
+  {
+    Sample peak = 0;
+    for (const auto &nd : node) peak = std::max(peak, std::abs(nd.buffer));
+    for (size_t idx = 0; idx < nLeaf; ++idx) {
+      const size_t slot = leaf.size() - 1 - idx;
+      const Leaf &lf = leaf[slot];
+      peak = std::max({peak, std::abs(lf.buffer), std::abs(lf.w1)});
+
+      const Sample *buf = arena.data() + slot * stride;
+      const int timeInt
+        = int(std::clamp<Sample>(Sample(2) * sampleRate * prm.seconds[idx], 0, size));
+      int ptr = lf.wptr;
+      for (int n = 0; n < std::min(timeInt + 2, size); ++n) {
+        if (--ptr < 0) ptr += size;
+        peak = std::max(peak, std::abs(buf[ptr]));
+      }
+    }
+    return peak;
+  }
+
+  Sample process(Sample input, Sample sampleRate, const NestParameter<Sample> &prm)
+  {
+    std::array<size_t, nDepth> first;   // First section of current nest.
+    std::array<size_t, nDepth> current; // Section in process.
+
+    size_t depth = nDepth - 1;
+    size_t nest = 0;
+    while (true) {
+      // Feed forward to the last section of each nest, down to depth 1.
+      while (true) {
+        Node *nd = node.data() + nodeOffset[depth];
+        const Sample *feed = prm.feed[depth];
+        first[depth] = nest * section[depth];
+        current[depth] = first[depth] + section[depth] - 1;
+        for (size_t idx = first[depth]; idx <= current[depth]; ++idx) {
+          input -= feed[idx] * nd[idx].buffer;
+          nd[idx].in = input;
+        }
+        if (depth == 0) break;
+        nest = current[depth];
+        --depth;
+      }
+
+      for (size_t k = 0; k < section[0]; ++k) {
+        const size_t idx = current[0] - k;
+        auto apOut = processAllpass(
+          leaf.size() - 1 - idx, input, sampleRate, prm.seconds[idx], prm.innerFeed[idx]);
+        input = feedBack(0, idx, prm.feed[0][idx], apOut);
+      }
+
+      // Output of a nest is the input to the previous section of parent nest.
+      while (true) {
+        if (++depth >= nDepth) return input;
+        auto &idx = current[depth];
+        input = feedBack(depth, idx, prm.feed[depth][idx], input);
+        if (idx > first[depth]) {
+          nest = --idx;
+          --depth;
+          break;
+        }
+      }
+    }
+  }
+
+private:
+  struct Node {
+    Sample in = 0;
+    Sample buffer = 0;
+  };
+
+  struct Leaf {
+    Sample buffer = 0;
+    Sample w1 = 0;
+    int wptr = 0;
+  };
+
+  inline Sample feedBack(size_t depth, size_t idx, Sample feed, Sample apOut)
+  {
+    Node &nd = node[nodeOffset[depth] + idx];
+    auto out = nd.buffer + feed * nd.in;
+    nd.buffer = apOut;
+    return out;
+  }
+
+  // Same as `LongAllpass::process` of L3Reverb and L4Reverb. gain in [0, 1].
+  inline Sample processAllpass(
+    size_t slot, Sample input, Sample sampleRate, Sample seconds, Sample gain)
+  {
+    Leaf &lf = leaf[slot];
+    Sample *buf = arena.data() + slot * stride;
+
+    input -= gain * lf.buffer;
+    auto output = lf.buffer + gain * input;
+
+    Sample timeInSample = std::clamp<Sample>(Sample(2) * sampleRate * seconds, 0, size);
+
+    auto timeInt = int(timeInSample);
+    Sample rFraction = timeInSample - Sample(timeInt);
+
+    int rptr = lf.wptr - timeInt;
+    if (rptr < 0) rptr += size;
+
+    buf[lf.wptr] = Sample(0.5) * (input + lf.w1);
+    if (++lf.wptr >= size) lf.wptr -= size;
+
+    buf[lf.wptr] = input;
+    if (++lf.wptr >= size) lf.wptr -= size;
+
+    lf.w1 = input;
+
+    const int i1 = rptr;
+    if (++rptr >= size) rptr -= size;
+    const int i0 = rptr;
+
+    lf.buffer = buf[i0] - rFraction * (buf[i0] - buf[i1]);
+    return output;
+  }
+
+  int size = 4;
+  size_t stride = 4; // Distance between delay buffers in `arena`.
+  std::array<size_t, nDepth> nodeOffset{};
+  std::vector<Node> node;
+  std::vector<Leaf> leaf;
+  std::vector<Sample> arena;
+};
+
+} // namespace SomeDSP
@@ -0,0 +1,62 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace SomeDSP {
+
+// Number of workers used by `parallelFor` for `nTask` tasks.
+inline size_t getParallelWorkerCount(size_t nTask)
+{
+  size_t nThread = std::thread::hardware_concurrency();
+  return std::clamp<size_t>(nThread, 1, std::max<size_t>(nTask, 1));
+}
+
+/**
+Calls `func(workerIndex, taskIndex)` for each `taskIndex` in [0, nTask). Returns after all
+tasks are done.
+
+`workerIndex` is in [0, nWorker). A worker runs one task at a time, so the caller can give
+each worker its own scratch buffer indexed by `workerIndex`. Worker 0 runs on the calling
+thread.
+
+Tasks are taken from a shared counter, so uneven task length is balanced. Don't use this
+on audio thread.
+*/
+template<typename Func> void parallelFor(size_t nWorker, size_t nTask, Func func)
+{
+  std::atomic<size_t> next{0};
+  auto work = [&](size_t workerIndex) {
+    size_t task;
+    while ((task = next.fetch_add(1, std::memory_order_relaxed)) < nTask)
+      func(workerIndex, task);
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(nWorker);
+  for (size_t idx = 1; idx < nWorker; ++idx) threads.emplace_back(work, idx);
+  work(0);
+  for (auto &thread : threads) thread.join();
+}
+
+} // namespace SomeDSP
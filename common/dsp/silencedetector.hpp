@@ -0,0 +1,132 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace SomeDSP {
+
+/**
+Puts DSP to sleep while its input and internal state are silent. Typical usage in
+`process`:
+
+```
+if (silence.isSleeping(length, in0, in1)) {
+  std::fill(out0, out0 + length, 0.0f);
+  std::fill(out1, out1 + length, 0.0f);
+  return;
+}
+for (size_t i = 0; i < length; ++i) {
+  // Process a sample.
+  silence.track(stateSignal);
+}
+silence.endBlock(length);
+```
+
+`track` takes a signal which represents the state, like output of a delay network
+before dry/wet mix. Output after the mix misses the tail when wet is 0.
+
+DSP falls asleep when input and tracked signal stay below `threshold` for `holdSeconds`.
+Hold time must be longer than the longest path through the network, so that residue in
+delay buffers has come out at least once. For delays in series, it's the sum of delay
+times. `setHold` can be called on every block when delay times are changing. State is
+left as is while sleeping, and DSP wakes up on the first block which has input above
+`threshold`. Instruments call `wake` on note-on.
+
+Sleep is disabled by default, because it stops time based state like LFO phase. Plugins
+call `setEnabled` from a parameter. While disabled, `isSleeping` always returns false.
+*/
+class SilenceDetector {
+public:
+  float threshold = 1e-6f; // -120 dB.
+
+  void setup(float sampleRate, float holdSeconds)
+  {
+    setHold(sampleRate, holdSeconds);
+    reset();
+  }
+
+  // While quiet, hold time doesn't shrink. Signal which entered longer delay may be still
+  // on the way after delay time is shortened.
+  void setHold(float sampleRate, float holdSeconds)
+  {
+    const auto samples = size_t(sampleRate * holdSeconds);
+    holdSamples = quietSamples == 0 ? samples : std::max(holdSamples, samples);
+  }
+
+  void setEnabled(bool enable)
+  {
+    if (enabled == enable) return;
+    enabled = enable;
+    wake();
+  }
+
+  void reset()
+  {
+    peak = 0;
+    quietSamples = 0;
+    sleeping = false;
+  }
+
+  void wake()
+  {
+    quietSamples = 0;
+    sleeping = false;
+  }
+
+  // Call at the start of block. `in0` and `in1` can be nullptr.
+  bool isSleeping(size_t length, const float *in0, const float *in1)
+  {
+    if (!enabled) return false;
+    peak = std::max(peakOf(length, in0), peakOf(length, in1));
+    if (peak >= threshold) wake();
+    return sleeping;
+  }
+
+  inline void track(float value) { peak = std::max(peak, std::fabs(value)); }
+
+  void endBlock(size_t length)
+  {
+    if (!enabled) return;
+    if (peak >= threshold) {
+      wake();
+      return;
+    }
+    quietSamples = std::min(quietSamples + length, holdSamples);
+    if (quietSamples >= holdSamples) sleeping = true;
+  }
+
+private:
+  static float peakOf(size_t length, const float *data)
+  {
+    float value = 0;
+    if (data == nullptr) return value;
+    for (size_t i = 0; i < length; ++i) value = std::max(value, std::fabs(data[i]));
+    return value;
+  }
+
+  float peak = 0;
+  size_t holdSamples = 0;
+  size_t quietSamples = 0;
+  bool sleeping = false;
+  bool enabled = false;
+};
+
+} // namespace SomeDSP
@@ -53,16 +53,36 @@ public:
   void reset() { value = 0; }
   Vec16f process(Vec16f input) { return value += kp * (input - value); }
 
+  void copyLane(int index, const PController16 &src, int srcIndex)
+  {
+    kp.insert(index, src.kp[srcIndex]);
+    value.insert(index, src.value[srcIndex]);
+  }
+
 private:
   Vec16f kp = 1; // In [0, 1].
   Vec16f value = 0;
 };
 
+/**
+Parameters of LinearSmoother, RotarySmoother, ExpSmoother and ExpSmoother16. Members are
+static, so all instances of a plugin in a process share them. DSPCore sets them in
+`setup`, `setParameters` and `process`.
+
+`setSampleRate` also resets `bufferSize`. Otherwise the first `push` of a new instance
+depends on the last buffer size of the previous instance, and output changes with the
+order of instances.
+
+Instances running concurrently on different threads still overwrite each other. Only
+L4Reverb has moved to SmootherContext. Other plugins keep SmootherCommon, because moving
+them requires a context to be passed to every `push` and `process` of their smoothers.
+*/
 template<typename Sample> class SmootherCommon {
 public:
   static void setSampleRate(Sample _sampleRate, Sample time = 0.04)
   {
     sampleRate = _sampleRate;
+    bufferSize = Sample(44100); // Same as the initial value.
     setTime(time);
   }
 
@@ -85,6 +105,46 @@ template<typename Sample> Sample SmootherCommon<Sample>::timeInSamples = 0.0;
 template<typename Sample> Sample SmootherCommon<Sample>::kp = 1.0;
 template<typename Sample> Sample SmootherCommon<Sample>::bufferSize = 44100.0;
 
+/**
+Per instance counterpart of SmootherCommon. Members of SmootherCommon are shared by all
+plugin instances in a process, so instances on different threads or with different buffer
+sizes overwrite each other. DSPCore can own a SmootherContext instead, and pass it to
+ExpSmootherBank, or pass `kp` to `ExpSmoother::process(kp)`.
+
+`decay[n]` is `(1 - kp)^(n + 1)`, and it's used to compute ramps of ExpSmootherBank.
+*/
+class SmootherContext {
+public:
+  static constexpr size_t blockSize = 64; // Must be multiple of 16.
+
+  void setSampleRate(float sampleRate, float time = 0.04f)
+  {
+    this->sampleRate = sampleRate;
+    setTime(time);
+  }
+
+  void setTime(float seconds)
+  {
+    timeInSamples = seconds * sampleRate;
+
+    const float newKp = float(PController<double>::cutoffToP(
+      sampleRate, std::clamp<double>(1.0 / seconds, 0.0, sampleRate / 2.0)));
+    if (newKp == kp) return;
+    kp = newKp;
+
+    double gain = 1.0;
+    for (auto &dcy : decay) dcy = float(gain *= 1.0 - double(kp));
+  }
+
+  void setBufferSize(float bufferSize) { this->bufferSize = bufferSize; }
+
+  float sampleRate = 44100.0f;
+  float timeInSamples = 0.0f;
+  float kp = 1.0f;
+  float bufferSize = 44100.0f;
+  alignas(64) std::array<float, blockSize> decay{};
+};
+
 template<typename Sample> class ExpSmoother {
 public:
   Sample value = 0;
@@ -94,6 +154,135 @@ public:
   void reset(Sample value = 0) { this->value = value; }
   void push(Sample newTarget) { target = newTarget; }
   Sample process() { return value += SmootherCommon<Sample>::kp * (target - value); }
+  Sample process(Sample kp) { return value += kp * (target - value); }
+};
+
+/**
+Block rate version of ExpSmoother for `nSmoother` values. `process()` fills ramps of up to
+`SmootherContext::blockSize` samples, and returns the number of filled samples. A ramp is
+computed in closed form `target + (value - target) * decay[n]`, so the loop runs on SIMD.
+
+Settled smoothers are skipped. Their ramp keeps holding the target.
+
+```
+for (size_t i = 0; i < length;) {
+  const size_t blockLength = bank.process(context, length - i);
+  const float *gain = bank.ramp(0);
+  for (size_t j = 0; j < blockLength; ++j, ++i) out[i] = gain[j] * in[i];
+}
+```
+*/
+template<size_t nSmoother> class alignas(64) ExpSmootherBank {
+public:
+  static constexpr size_t blockSize = SmootherContext::blockSize;
+
+  inline float getValue(size_t index) const { return value[index]; }
+  inline const float *ramp(size_t index) const { return buffer[index].data(); }
+  inline bool isSettled(size_t index) const { return settled[index]; }
+
+  void reset(size_t index, float value = 0.0f)
+  {
+    this->value[index] = value;
+    target[index] = value;
+    settled[index] = false;
+  }
+
+  void push(size_t index, float newTarget)
+  {
+    if (target[index] == newTarget) return;
+    target[index] = newTarget;
+    settled[index] = false;
+  }
+
+  size_t process(const SmootherContext &context, size_t length)
+  {
+    const size_t blockLength = std::min(length, blockSize);
+    if (blockLength == 0) return 0;
+
+    for (size_t idx = 0; idx < nSmoother; ++idx) {
+      if (settled[idx]) continue;
+
+      auto &buf = buffer[idx];
+      const float diff = value[idx] - target[idx];
+      if (somefabs<float>(diff) <= 1e-7f * std::max(1.0f, somefabs<float>(target[idx]))) {
+        value[idx] = target[idx];
+        buf.fill(target[idx]);
+        settled[idx] = true;
+        continue;
+      }
+
+      const Vec16f vecTarget(target[idx]);
+      const Vec16f vecDiff(diff);
+      Vec16f decay;
+      for (size_t n = 0; n < blockLength; n += 16) {
+        decay.load_a(context.decay.data() + n);
+        mul_add(vecDiff, decay, vecTarget).store_a(buf.data() + n);
+      }
+      value[idx] = buf[blockLength - 1];
+    }
+    return blockLength;
+  }
+
+private:
+  alignas(64) std::array<std::array<float, blockSize>, nSmoother> buffer{};
+  std::array<float, nSmoother> value{};
+  std::array<float, nSmoother> target{};
+  std::array<bool, nSmoother> settled{};
+};
+
+/**
+Array of ExpSmoother stored as structure of arrays. `process(kp)` advances all values by
+a sample, 16 lanes at a time.
+
+Values are settled when `value + kp * (target - value)` rounds to `value` for all lanes.
+It's a fixed point, so skipping `process` after that gives exactly the same output as
+ExpSmoother.
+
+Use this when a lot of values are read on every sample, like coefficients of nested
+allpass. Ramps of ExpSmootherBank don't fit in cache for such number of values.
+*/
+template<size_t nSmoother> class alignas(64) ExpSmootherArray {
+public:
+  inline const float *data() const { return value.data(); }
+  inline float getValue(size_t index) const { return value[index]; }
+  inline bool isSettled() const { return settled; }
+
+  void reset(size_t index, float value = 0.0f)
+  {
+    this->value[index] = value;
+    target[index] = value;
+  }
+
+  void push(size_t index, float newTarget)
+  {
+    if (target[index] == newTarget) return;
+    target[index] = newTarget;
+    settled = false;
+  }
+
+  void process(float kp)
+  {
+    if (settled) return;
+
+    Vec16fb isFixed(true);
+    Vec16f vecValue;
+    Vec16f vecTarget;
+    for (size_t n = 0; n < paddedSize; n += 16) {
+      vecValue.load_a(value.data() + n);
+      vecTarget.load_a(target.data() + n);
+      const Vec16f next = vecValue + kp * (vecTarget - vecValue);
+      isFixed = isFixed & (next == vecValue);
+      next.store_a(value.data() + n);
+    }
+    settled = horizontal_and(isFixed);
+  }
+
+private:
+  static constexpr size_t paddedSize = 16 * ((nSmoother + 15) / 16);
+
+  alignas(64) std::array<float, paddedSize> value{};
+  alignas(64) std::array<float, paddedSize> target{};
+  bool settled = false;
 };
 
 class alignas(64) ExpSmoother16 {
@@ -0,0 +1,144 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+
+namespace SomeDSP {
+
+// 64-bit FNV-1a. Used to make a key from the parameters which changes table content.
+inline uint64_t fnv1a(const void *data, size_t size, uint64_t hash = 0xcbf29ce484222325)
+{
+  auto ptr = static_cast<const uint8_t *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= ptr[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+template<typename T> inline uint64_t fnv1a(const T &value, uint64_t hash)
+{
+  return fnv1a(&value, sizeof(T), hash);
+}
+
+/**
+Process wide cache of read-only tables. Plugin instances with same `Config` share one
+table.
+
+`Config` must provide `uint64_t hash() const` and `operator==`. Hash is only used for
+fast rejection, so collision doesn't cause wrong table to be shared.
+
+Cache only holds `std::weak_ptr`. A table is freed when the last instance using it
+releases its `std::shared_ptr`.
+
+If another thread is building the table for same `Config`, `acquire()` waits for it
+instead of building a duplicate. Therefore `acquire()` may block. Don't call it on audio
+thread. TableWorker calls it on its worker thread.
+
+If `build` throws, the exception is passed to the caller of `acquire()`. Waiting threads
+are woken up, and the next one builds the table again.
+*/
+template<typename Table, typename Config> class SharedTableCache {
+public:
+  using BuildFunc = std::function<void(Table &, const Config &)>;
+
+  static SharedTableCache &instance()
+  {
+    static SharedTableCache cache;
+    return cache;
+  }
+
+  std::shared_ptr<const Table> acquire(const Config &config, BuildFunc build)
+  {
+    const auto hash = config.hash();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    removeExpired();
+
+    auto it = find(hash, config);
+    while (it != entries.end()) {
+      if (auto table = it->table.lock()) return table;
+      if (!it->isBuilding) break;
+      condition.wait(lock);
+      it = find(hash, config);
+    }
+    if (it == entries.end()) it = entries.insert(entries.end(), Entry{hash, config});
+    it->isBuilding = true;
+    lock.unlock();
+
+    // std::list iterator stays valid while other entries are added or removed. This
+    // entry itself isn't removed because `isBuilding` is set.
+    std::shared_ptr<Table> table;
+    try {
+      table = std::make_shared<Table>();
+      build(*table, config);
+    } catch (...) {
+      // Waiters wake up with expired entry, and one of them retries the build.
+      finishBuild(it, nullptr);
+      throw;
+    }
+    finishBuild(it, table);
+    return table;
+  }
+
+private:
+  struct Entry {
+    uint64_t hash;
+    Config config;
+    std::weak_ptr<const Table> table{};
+    bool isBuilding = false;
+  };
+
+  SharedTableCache() = default;
+
+  void finishBuild(
+    typename std::list<Entry>::iterator it, const std::shared_ptr<const Table> &table)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      it->table = table;
+      it->isBuilding = false;
+    }
+    condition.notify_all();
+  }
+
+  typename std::list<Entry>::iterator find(uint64_t hash, const Config &config)
+  {
+    for (auto it = entries.begin(); it != entries.end(); ++it)
+      if (it->hash == hash && it->config == config) return it;
+    return entries.end();
+  }
+
+  void removeExpired()
+  {
+    entries.remove_if([](const Entry &e) { return !e.isBuilding && e.table.expired(); });
+  }
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::list<Entry> entries;
+};
+
+} // namespace SomeDSP
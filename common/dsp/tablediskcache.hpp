@@ -0,0 +1,395 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "../../lib/ghc/fs_std.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace SomeDSP {
+
+// Appends raw bytes of `value`. Used to serialize the config of a table for
+// TableDiskCache.
+template<typename T> inline void appendBytes(std::vector<uint8_t> &bytes, const T &value)
+{
+  static_assert(std::is_trivially_copyable<T>::value);
+  auto ptr = reinterpret_cast<const uint8_t *>(&value);
+  bytes.insert(bytes.end(), ptr, ptr + sizeof(T));
+}
+
+// Read only view of a cache file. File stays mapped while this object is alive, even if
+// the file is evicted by other instance.
+class MappedTableFile {
+public:
+  MappedTableFile(void *address, size_t mapSize, size_t offset)
+    : address(address), mapSize(mapSize), offset(offset)
+  {
+  }
+
+  ~MappedTableFile() { munmap(address, mapSize); }
+
+  MappedTableFile(const MappedTableFile &) = delete;
+  MappedTableFile &operator=(const MappedTableFile &) = delete;
+
+  // Mapping is private. Writing to it doesn't change the file.
+  uint8_t *data() const { return static_cast<uint8_t *>(address) + offset; }
+  size_t size() const { return mapSize - offset; }
+
+  // Reads every page, so the audio thread doesn't take page faults on first access.
+  // Used where `MAP_POPULATE` isn't available.
+  void prefault() const
+  {
+    madvise(address, mapSize, MADV_WILLNEED);
+
+    const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    auto ptr = static_cast<const volatile uint8_t *>(address);
+    uint8_t sum = 0;
+    for (size_t i = 0; i < mapSize; i += pageSize) sum += ptr[i];
+    (void)sum;
+  }
+
+private:
+  void *address;
+  size_t mapSize;
+  size_t offset;
+};
+
+/**
+On-disk cache of generated tables. Files are placed at
+`$XDG_CONFIG_HOME/UhhyouPlugins/tablecache/<name>/<hash>.table`.
+
+Cache is only enabled when `$XDG_CONFIG_HOME/UhhyouPlugins/tablecache` exists, so users
+opt in by creating the directory.
+
+A file is rejected when any of magic, format version, table `version`, hash or sample
+rate differs. Bump `version` when the table content or layout of a plugin changes.
+Serialized config is also written after the header, and compared byte by byte on load,
+so a hash collision or a change of config layout causes a rebuild instead of a wrong
+table.
+
+Last write time of a file is used as last access time. When total size exceeds
+`maxBytes`, least recently used files are removed.
+
+Mapped pages are populated in `load()`, so the caller must not be the audio thread.
+
+`store()` only queues the write. A writer thread writes the file and evicts old ones, so
+a freshly built table is published without waiting for disk. Files are written to a
+temporary name and then renamed, so other processes never map a partially written file.
+Pending writes are discarded on destruction. Errors are ignored and treated as cache
+miss.
+*/
+class TableDiskCache {
+public:
+  static constexpr uint64_t defaultMaxBytes = uint64_t(1) << 30; // 1 GiB.
+
+  struct Chunk {
+    const void *data;
+    size_t size;
+  };
+
+  TableDiskCache(
+    const std::string &name, uint32_t version, uint64_t maxBytes = defaultMaxBytes)
+    : version(version), maxBytes(maxBytes)
+  {
+    auto root = getXdgConfigHome();
+    if (root.empty()) return;
+    root /= fs::path("UhhyouPlugins/tablecache");
+
+    std::error_code ec;
+    if (!fs::is_directory(root, ec)) return;
+    directory = root / fs::path(name);
+    fs::create_directories(directory, ec);
+    if (ec) {
+      directory.clear();
+      return;
+    }
+
+    writer = std::thread(&TableDiskCache::runWriter, this);
+  }
+
+  ~TableDiskCache()
+  {
+    if (!writer.joinable()) return;
+    {
+      std::lock_guard<std::mutex> lock(jobMutex);
+      isQuitting = true;
+    }
+    jobCondition.notify_one();
+    writer.join();
+  }
+
+  TableDiskCache(const TableDiskCache &) = delete;
+  TableDiskCache &operator=(const TableDiskCache &) = delete;
+
+  bool isEnabled() const { return !directory.empty(); }
+
+  // Returns nullptr on cache miss.
+  std::shared_ptr<MappedTableFile>
+  load(uint64_t hash, float sampleRate, const std::vector<uint8_t> &config)
+  {
+    if (!isEnabled()) return nullptr;
+
+    auto path = getPath(hash);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+
+    struct stat st;
+    void *address = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && size_t(st.st_size) > sizeof(Header)) {
+      address
+        = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, mapFlags, fd, 0);
+    }
+    close(fd);
+    if (address == MAP_FAILED) return nullptr;
+
+    const size_t fileSize = size_t(st.st_size);
+    Header header;
+    std::memcpy(&header, address, sizeof(Header));
+    const bool hasConfig = header.configSize == config.size()
+      && getPayloadOffset(config.size()) + header.payloadSize == fileSize;
+    auto file = std::make_shared<MappedTableFile>(
+      address, fileSize, hasConfig ? getPayloadOffset(config.size()) : fileSize);
+    if (
+      !hasConfig || std::memcmp(header.magic, magic, sizeof(magic)) != 0
+      || header.formatVersion != formatVersion || header.tableVersion != version
+      || header.hash != hash || header.sampleRate != sampleRate
+      || std::memcmp(
+           static_cast<uint8_t *>(address) + sizeof(Header), config.data(), config.size())
+        != 0)
+      return nullptr;
+
+#ifndef MAP_POPULATE
+    file->prefault();
+#endif
+
+    // Mark as recently used.
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+    return file;
+  }
+
+  /**
+  Queues a write of `chunks`. `owner` must keep the memory of `chunks` alive, and the
+  memory must not be changed afterwards. When `owner` is nullptr, the file is written
+  before return. `config` is copied.
+  */
+  void store(
+    uint64_t hash,
+    float sampleRate,
+    const std::vector<uint8_t> &config,
+    std::shared_ptr<const void> owner,
+    std::vector<Chunk> chunks)
+  {
+    if (!isEnabled()) return;
+
+    if (!owner) {
+      write(hash, sampleRate, config, chunks);
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(jobMutex);
+      jobs.push_back({hash, sampleRate, config, std::move(owner), std::move(chunks)});
+    }
+    jobCondition.notify_one();
+  }
+
+private:
+  struct Header {
+    char magic[8];
+    uint32_t formatVersion;
+    uint32_t tableVersion;
+    uint64_t hash;
+    float sampleRate;
+    uint32_t reserved = 0;
+    uint64_t payloadSize;
+    uint64_t configSize; // Config follows header, and is zero padded to `alignment`.
+    uint8_t padding[16] = {};
+  };
+  static_assert(sizeof(Header) == 64);
+
+  static constexpr char magic[8] = {'U', 'h', 'h', 'y', 'T', 'b', 'l', '\0'};
+  static constexpr uint32_t formatVersion = 2;
+  static constexpr size_t alignment = 64; // Of payload.
+
+  static size_t getPayloadOffset(size_t configSize)
+  {
+    return sizeof(Header) + (configSize + alignment - 1) / alignment * alignment;
+  }
+
+  // Pages are read in `mmap`, instead of page faults on audio thread.
+#ifdef MAP_POPULATE
+  static constexpr int mapFlags = MAP_PRIVATE | MAP_POPULATE;
+#else
+  static constexpr int mapFlags = MAP_PRIVATE;
+#endif
+
+  // Specification of $XDG_CONFIG_HOME:
+  // https://specifications.freedesktop.org/basedir-spec/basedir-spec-latest.html
+  static fs::path getXdgConfigHome()
+  {
+    const char *configDir = std::getenv("XDG_CONFIG_HOME");
+    if (configDir != nullptr) return fs::path(configDir);
+
+    const char *home = std::getenv("HOME");
+    if (home != nullptr) return fs::path(home) / ".config";
+
+    return fs::path("");
+  }
+
+  fs::path getPath(uint64_t hash) const
+  {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.table", (unsigned long long)hash);
+    return directory / fs::path(name);
+  }
+
+  // Removes least recently used files until total size fits in `maxBytes`.
+  void evict()
+  {
+    std::lock_guard<std::mutex> lock(evictMutex);
+
+    struct Entry {
+      fs::path path;
+      fs::file_time_type time;
+      uintmax_t size;
+    };
+    std::vector<Entry> entries;
+    uintmax_t totalSize = 0;
+
+    std::error_code ec;
+    for (const auto &item : fs::directory_iterator(directory, ec)) {
+      if (item.path().extension() != ".table") continue;
+      Entry entry{item.path(), item.last_write_time(ec), item.file_size(ec)};
+      if (ec) continue;
+      totalSize += entry.size;
+      entries.push_back(entry);
+    }
+    if (totalSize <= maxBytes) return;
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) {
+      return lhs.time < rhs.time;
+    });
+    for (const auto &entry : entries) {
+      if (totalSize <= maxBytes) break;
+      if (fs::remove(entry.path, ec)) totalSize -= entry.size;
+    }
+  }
+
+  struct Job {
+    uint64_t hash;
+    float sampleRate;
+    std::vector<uint8_t> config;
+    std::shared_ptr<const void> owner;
+    std::vector<Chunk> chunks;
+  };
+
+  void write(
+    uint64_t hash,
+    float sampleRate,
+    const std::vector<uint8_t> &config,
+    const std::vector<Chunk> &chunks)
+  {
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.formatVersion = formatVersion;
+    header.tableVersion = version;
+    header.hash = hash;
+    header.sampleRate = sampleRate;
+    header.payloadSize = 0;
+    for (const auto &chunk : chunks) header.payloadSize += chunk.size;
+    header.configSize = config.size();
+    const size_t offset = getPayloadOffset(config.size());
+    if (header.payloadSize + offset > maxBytes) return;
+
+    auto path = getPath(hash);
+    auto tmpPath = path;
+    tmpPath += fs::path(
+      ".tmp" + std::to_string(getpid()) + "_"
+      + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+
+    std::FILE *fp = std::fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr) return;
+    bool isWritten = std::fwrite(&header, sizeof(Header), 1, fp) == 1;
+    if (isWritten && !config.empty())
+      isWritten = std::fwrite(config.data(), 1, config.size(), fp) == config.size();
+    const std::vector<uint8_t> zeros(offset - sizeof(Header) - config.size(), 0);
+    if (isWritten && !zeros.empty())
+      isWritten = std::fwrite(zeros.data(), 1, zeros.size(), fp) == zeros.size();
+    for (const auto &chunk : chunks) {
+      if (!isWritten) break;
+      isWritten = std::fwrite(chunk.data, 1, chunk.size, fp) == chunk.size;
+    }
+    isWritten = std::fclose(fp) == 0 && isWritten;
+
+    std::error_code ec;
+    if (isWritten) fs::rename(tmpPath, path, ec);
+    if (!isWritten || ec) {
+      fs::remove(tmpPath, ec);
+      return;
+    }
+
+    evict();
+  }
+
+  void runWriter()
+  {
+    while (true) {
+      Job job;
+      {
+        std::unique_lock<std::mutex> lock(jobMutex);
+        jobCondition.wait(lock, [&] { return isQuitting || !jobs.empty(); });
+        if (isQuitting) return;
+        job = std::move(jobs.front());
+        jobs.pop_front();
+      }
+      write(job.hash, job.sampleRate, job.config, job.chunks);
+    }
+  }
+
+  fs::path directory;
+  uint32_t version;
+  uint64_t maxBytes;
+  std::mutex evictMutex;
+
+  std::mutex jobMutex;
+  std::condition_variable jobCondition;
+  std::deque<Job> jobs;
+  bool isQuitting = false;
+  std::thread writer; // Joined in destructor, before other members are destroyed.
+};
+
+} // namespace SomeDSP
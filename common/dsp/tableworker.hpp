@@ -0,0 +1,171 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace SomeDSP {
+
+/**
+Double buffered table which is built on a background thread.
+
+Tables are held as `std::shared_ptr<const Table>`, so they can be shared with other
+instances through `SharedTableCache`. Worker thread is the only one which assigns or
+releases them. Therefore a table is never freed on audio thread.
+
+`Config` must provide `operator==`. A request with the same config as the latest table is
+ignored.
+
+`request()` can be called from any thread. It only copies `Config` under a mutex which is
+held by the worker just as long as the copy takes.
+
+`acquire()` must be called from the audio thread at the start of a processing block. It
+swaps the front and back buffer when the worker finished a new table, and returns the
+front table. The returned table stays valid until next call of `acquire()`.
+
+Index of front buffer and "back is ready" flag are packed into `state`, so both sides
+can update them with a single atomic operation:
+
+- Audio thread flips front index only when ready bit is set.
+- Worker clears ready bit before writing to back buffer. After that, front index won't
+  change until worker sets ready bit again.
+*/
+template<typename Table, typename Config> class TableWorker {
+public:
+  using BuildFunc = std::function<std::shared_ptr<const Table>(const Config &)>;
+
+  TableWorker(BuildFunc build) : build(build), thread(&TableWorker::run, this) {}
+
+  ~TableWorker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      isQuitting = true;
+    }
+    condition.notify_one();
+    thread.join();
+  }
+
+  TableWorker(const TableWorker &) = delete;
+  TableWorker &operator=(const TableWorker &) = delete;
+
+  // Latest request overwrites older one which isn't yet started.
+  void request(const Config &config)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      pending = config;
+      hasRequest = true;
+    }
+    condition.notify_one();
+  }
+
+  // Returns nullptr until first table is built.
+  const Table *acquire()
+  {
+    uint32_t current = state.load(std::memory_order_acquire);
+    if (current & readyBit) {
+      uint32_t next = (current ^ frontBit) & ~readyBit;
+      if (state.compare_exchange_strong(current, next, std::memory_order_acq_rel))
+        current = next;
+    }
+    return table[current & frontBit].get();
+  }
+
+  // Returns true when `acquire()` would return a table. For tests which wait for the first
+  // build. Call it from the thread which calls `acquire()`.
+  bool isReady() const
+  {
+    const uint32_t current = state.load(std::memory_order_acquire);
+    return (current & readyBit) || table[current & frontBit] != nullptr;
+  }
+
+private:
+  static constexpr uint32_t frontBit = 1;
+  static constexpr uint32_t readyBit = 2;
+
+  void run()
+  {
+    Config config;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!condition.wait_for(
+          lock, std::chrono::milliseconds(100), [&] { return hasRequest || isQuitting; }))
+          releaseStaleBack();
+        if (isQuitting) return;
+        config = pending;
+        hasRequest = false;
+      }
+
+      // Same table is in front, or waiting to be swapped. Rebuilding it would throw away
+      // a table which isn't swapped yet, and audio thread has nothing to play meanwhile.
+      if (isBuilt && config == built) continue;
+
+      // Reclaim back buffer. If the audio thread swapped just before this line, previous
+      // front becomes back, and it's no longer read because swap happens at block start.
+      uint32_t previous = state.fetch_and(~readyBit, std::memory_order_acq_rel);
+      auto &back = table[(previous & frontBit) ^ frontBit];
+      back.reset(); // Reduce peak memory usage.
+      try {
+        back = build(config);
+      } catch (...) {
+        // Typically std::bad_alloc. Audio thread keeps the front table.
+        isBuilt = false;
+        continue;
+      }
+      built = config;
+      isBuilt = true;
+
+      state.fetch_or(readyBit, std::memory_order_acq_rel);
+    }
+  }
+
+  // After swap, back holds previous table. It's released here to free memory as soon as
+  // possible. Front index doesn't change while ready bit is cleared.
+  void releaseStaleBack()
+  {
+    uint32_t current = state.load(std::memory_order_acquire);
+    if (current & readyBit) return;
+    table[(current & frontBit) ^ frontBit].reset();
+  }
+
+  BuildFunc build;
+
+  std::shared_ptr<const Table> table[2];
+  std::atomic<uint32_t> state{0};
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  Config pending;
+  bool hasRequest = false;
+
+  Config built; // Config of the latest table. Only accessed by worker.
+  bool isBuilt = false;
+  bool isQuitting = false;
+
+  std::thread thread; // Must be the last member. It starts in constructor.
+};
+
+} // namespace SomeDSP
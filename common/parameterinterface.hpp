@@ -29,8 +29,5 @@ public:
   virtual double getInt(uint32_t index) const = 0;
   virtual double parameterChanged(uint32_t index, float raw) = 0;
   virtual double updateValue(uint32_t index, float normalized) = 0;
-
-#ifndef TEST_BUILD
   virtual void loadProgram(uint32_t index) = 0;
-#endif
 };
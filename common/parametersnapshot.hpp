@@ -0,0 +1,165 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+Flat copy of parameter values for DSP. Values are published by the thread which sets
+parameters (writer), and read by audio thread (reader) without lock.
+
+Writer calls `set()` for changed values, then `publish()`. Reader calls `acquire()` at the
+start of a processing block. After that, `getFloat()`, `getInt()` and `isDirty()` return
+the values of the latest publish until next `acquire()`.
+
+Values are stored as float, so integer values must be less than 2^24 to be exact.
+
+`isDirty(index)` is true when the value was set after previous `acquire()`. Reader can
+skip recomputation of parameters which aren't dirty. `isDirty(first, last)` checks a
+range of indices at once.
+
+Synchronization is the same as `SomeDSP::TableWorker`. Front index and "back is ready"
+flag are packed into `state`:
+
+- Reader flips front index only when ready bit is set.
+- Writer clears ready bit before writing to back buffer. After that, front index won't
+  change until writer sets ready bit again.
+
+Writer only copies values changed since the back buffer was last written, so `publish()`
+is cheap when a few values are set.
+*/
+template<size_t nParameter> class ParameterSnapshot {
+public:
+  // Writer side.
+  void set(size_t index, float value)
+  {
+    staging[index] = value;
+    const uint64_t bit = uint64_t(1) << (index % 64);
+    for (auto &stl : stale) stl[index / 64] |= bit;
+    pending[index / 64] |= bit;
+  }
+
+  void publish()
+  {
+    const uint32_t previous = state.fetch_and(~readyBit, std::memory_order_acq_rel);
+    const uint32_t backIndex = (previous & frontBit) ^ frontBit;
+    auto &back = frame[backIndex];
+    auto &backStale = stale[backIndex];
+
+    // If ready bit was still set, reader hasn't taken previous publish yet.
+    const bool isAccumulating = previous & readyBit;
+    for (size_t word = 0; word < nWord; ++word) {
+      uint64_t bits = backStale[word];
+      while (bits != 0) {
+        const size_t index = 64 * word + countTrailingZero(bits);
+        back.value[index] = staging[index];
+        bits &= bits - 1;
+      }
+      backStale[word] = 0;
+
+      if (isAccumulating)
+        back.dirty[word] |= pending[word];
+      else
+        back.dirty[word] = pending[word];
+      pending[word] = 0;
+    }
+
+    state.fetch_or(readyBit, std::memory_order_acq_rel);
+  }
+
+  // Reader side.
+  void acquire()
+  {
+    uint32_t current = state.load(std::memory_order_acquire);
+    if (current & readyBit) {
+      uint32_t next = (current ^ frontBit) & ~readyBit;
+      if (state.compare_exchange_strong(current, next, std::memory_order_acq_rel)) {
+        frontIndex = next & frontBit;
+        return;
+      }
+    }
+    frame[frontIndex].dirty.fill(0); // Nothing changed since previous acquire.
+  }
+
+  inline float getFloat(size_t index) const { return frame[frontIndex].value[index]; }
+  inline uint32_t getInt(size_t index) const { return uint32_t(getFloat(index)); }
+
+  inline bool isDirty(size_t index) const
+  {
+    return frame[frontIndex].dirty[index / 64] & (uint64_t(1) << (index % 64));
+  }
+
+  bool isDirty() const
+  {
+    for (const auto &word : frame[frontIndex].dirty)
+      if (word != 0) return true;
+    return false;
+  }
+
+  // True when any of values in [first, last] is dirty.
+  bool isDirty(size_t first, size_t last) const
+  {
+    const auto &dirty = frame[frontIndex].dirty;
+    for (size_t word = first / 64; word <= last / 64; ++word) {
+      uint64_t mask = ~uint64_t(0);
+      if (word == first / 64) mask &= ~uint64_t(0) << (first % 64);
+      if (word == last / 64) mask &= ~uint64_t(0) >> (63 - last % 64);
+      if (dirty[word] & mask) return true;
+    }
+    return false;
+  }
+
+private:
+  static constexpr size_t nWord = (nParameter + 63) / 64;
+  static constexpr uint32_t frontBit = 1;
+  static constexpr uint32_t readyBit = 2;
+
+  struct alignas(64) Frame {
+    std::array<float, nParameter> value{};
+    std::array<uint64_t, nWord> dirty{};
+  };
+
+  static inline size_t countTrailingZero(uint64_t bits)
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return size_t(__builtin_ctzll(bits));
+#else
+    size_t count = 0;
+    while ((bits & 1) == 0) {
+      bits >>= 1;
+      ++count;
+    }
+    return count;
+#endif
+  }
+
+  // Reader only.
+  uint32_t frontIndex = 0;
+
+  // Shared.
+  std::array<Frame, 2> frame;
+  std::atomic<uint32_t> state{0};
+
+  // Writer only.
+  alignas(64) std::array<float, nParameter> staging{};
+  std::array<std::array<uint64_t, nWord>, 2> stale{};
+  std::array<uint64_t, nWord> pending{};
+};
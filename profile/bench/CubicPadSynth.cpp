@@ -0,0 +1,35 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../CubicPadSynth/dsp/dspcore.hpp"
+#include "bench.hpp"
+
+int main(int argc, char **argv)
+{
+  using ID = ParameterID::ID;
+
+  return Bench::run(
+    argc, argv,
+    {
+      "CubicPadSynth",
+      Bench::presetNames<GlobalParameter>(),
+      {ID::gain, ID::tableLowpass, ID::unisonDetune},
+      Bench::simdVariants<
+        Bench::TableWorkerTarget, DSPInterface, DSPCore_AVX512, DSPCore_AVX2,
+        DSPCore_SSE41, DSPCore_SSE2>(),
+    });
+}
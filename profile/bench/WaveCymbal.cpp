@@ -0,0 +1,51 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../WaveCymbal/dsp/dspcore.hpp"
+#include "bench.hpp"
+
+// Effect which also receives MIDI notes. `setParameters` doesn't take tempo.
+class WaveCymbalTarget : public Bench::DSPTarget<DSPCore> {
+public:
+  using DSPTarget::DSPTarget;
+
+  void pushMidiNote(
+    bool isNoteOn, uint32_t frame, int32_t noteId, int16_t pitch, float velocity) override
+  {
+    dsp->pushMidiNote(isNoteOn, frame, noteId, pitch, 0.0f, velocity);
+  }
+
+  void process(const Bench::Block &block) override
+  {
+    dsp->setParameters();
+    dsp->process(block.length, block.in0, block.in1, block.out0, block.out1);
+  }
+};
+
+int main(int argc, char **argv)
+{
+  using ID = ParameterID::ID;
+
+  return Bench::run(
+    argc, argv,
+    {
+      "WaveCymbal",
+      Bench::presetNames<GlobalParameter>(),
+      {ID::decay, ID::damping, ID::pulsePosition},
+      Bench::genericVariants<WaveCymbalTarget, DSPCore>(),
+    });
+}
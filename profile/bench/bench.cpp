@@ -0,0 +1,481 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+/*
+This source is splitted because nlohmann/json.hpp is slow to compile.
+*/
+
+#include "bench.hpp"
+#include "golden.hpp"
+
+#include "../../lib/json.hpp"
+#include "../../lib/vcl/vectorclass.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <utility>
+
+#include <xmmintrin.h>
+
+namespace Bench {
+
+struct Options {
+  double sampleRate = 48000.0;
+  double seconds = 10.0;
+  double warmup = 0.5; // In seconds. Not included in result.
+  std::vector<size_t> blockSizes{64, 256, 1024};
+  std::vector<std::string> isas; // Empty means all supported.
+  std::vector<std::string> presets{"Default"};
+  bool json = false;
+  bool idle = false;
+  bool automation = true;
+  std::vector<std::pair<uint32_t, float>> overrides; // Parameter ID and normalized value.
+  std::string renderDir;
+  std::string compareDir;
+};
+
+struct Result {
+  std::string preset;
+  std::string isa;
+  size_t blockSize;
+  double rtf;
+  double nsPerSample;
+  double p99BlockUs;
+};
+
+struct MidiEvent {
+  size_t frame;
+  bool isNoteOn;
+  int32_t noteId;
+  int16_t pitch;
+  float velocity;
+};
+
+void printHelp(const char *command)
+{
+  std::cout
+    << "Usage: " << command << " [options]\n"
+    << "  --seconds S         Length of rendered audio. Default is 10.\n"
+    << "  --warmup S          Length of untimed audio before --seconds. Default is\n"
+    << "                      0.5. Included in renders.\n"
+    << "  --sample-rate FS    Default is 48000.\n"
+    << "  --block N,N,...     Block sizes. Default is 64,256,1024.\n"
+    << "  --isa NAME,...      AVX512, AVX2, SSE41, SSE2 or generic. Default is all\n"
+    << "                      supported by this CPU.\n"
+    << "  --preset NAME,...   Preset names, or \"all\". Default is Default.\n"
+    << "  --json              Print a JSON object per line.\n"
+    << "  --idle              Only the first beat has input or notes. Measures the\n"
+    << "                      cost of plugins receiving silence. Sleep on silence is\n"
+    << "                      off by default. Turn on `autoSleep` with --set.\n"
+    << "  --static            Don't sweep parameters.\n"
+    << "  --set ID=V,...      Set normalized value V to parameter ID after loading\n"
+    << "                      preset.\n"
+    << "  --render DIR        Write outputs to DIR instead of timing. Only the first\n"
+    << "                      block size and, unless --isa is given, only the ISA\n"
+    << "                      used by the plugin are rendered.\n"
+    << "  --compare DIR       Compare outputs to the ones written by --render.\n";
+}
+
+std::vector<std::string> splitComma(const std::string &text)
+{
+  std::vector<std::string> list;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    if (!item.empty()) list.push_back(item);
+  return list;
+}
+
+bool parseOptions(int argc, char **argv, Options &opt)
+{
+  for (int idx = 1; idx < argc; ++idx) {
+    const std::string key(argv[idx]);
+    if (key == "--json") {
+      opt.json = true;
+      continue;
+    }
+    if (key == "--idle") {
+      opt.idle = true;
+      continue;
+    }
+    if (key == "--static") {
+      opt.automation = false;
+      continue;
+    }
+    if (key == "--help" || idx + 1 >= argc) return false;
+
+    const std::string value(argv[++idx]);
+    if (key == "--seconds") {
+      opt.seconds = std::stod(value);
+    } else if (key == "--warmup") {
+      opt.warmup = std::stod(value);
+    } else if (key == "--sample-rate") {
+      opt.sampleRate = std::stod(value);
+    } else if (key == "--block") {
+      opt.blockSizes.clear();
+      for (const auto &item : splitComma(value))
+        opt.blockSizes.push_back(std::stoul(item));
+    } else if (key == "--isa") {
+      opt.isas = splitComma(value);
+    } else if (key == "--preset") {
+      opt.presets = splitComma(value);
+    } else if (key == "--render") {
+      opt.renderDir = value;
+    } else if (key == "--compare") {
+      opt.compareDir = value;
+    } else if (key == "--set") {
+      for (const auto &item : splitComma(value)) {
+        const auto pos = item.find('=');
+        if (pos == std::string::npos) return false;
+        opt.overrides.emplace_back(
+          std::stoul(item.substr(0, pos)), std::stof(item.substr(pos + 1)));
+      }
+    } else {
+      return false;
+    }
+  }
+  if (!opt.renderDir.empty() && !opt.compareDir.empty()) return false;
+  return opt.seconds > 0 && opt.warmup >= 0 && opt.sampleRate > 0
+    && !opt.blockSizes.empty()
+    && std::none_of(opt.blockSizes.begin(), opt.blockSizes.end(), [](size_t size) {
+         return size == 0;
+       });
+}
+
+bool isSelected(const std::vector<std::string> &list, const std::string &name)
+{
+  if (list.empty()) return true;
+  for (const auto &item : list) {
+    if (item.size() != name.size()) continue;
+    if (std::equal(item.begin(), item.end(), name.begin(), [](char a, char b) {
+          return std::tolower(a) == std::tolower(b);
+        }))
+      return true;
+  }
+  return false;
+}
+
+// Noise bursts on every beat, and quiet saw wave under them. When `idle` is true, input
+// stops after the first beat.
+void fillInput(
+  std::vector<float> &in0, std::vector<float> &in1, double sampleRate, bool idle)
+{
+  std::minstd_rand rng{0};
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+  const size_t beat = size_t(sampleRate * 0.5);
+  const size_t burst = size_t(sampleRate * 0.05);
+  const float sawTick = float(110.0 / sampleRate);
+  float phase = 0;
+  for (size_t i = 0; i < in0.size(); ++i) {
+    phase += sawTick;
+    phase -= std::floor(phase);
+    const float saw = 0.1f * (2.0f * phase - 1.0f);
+
+    const bool isBurst = i % beat < burst;
+    in0[i] = saw + (isBurst ? 0.5f * dist(rng) : 0.0f);
+    in1[i] = saw + (isBurst ? 0.5f * dist(rng) : 0.0f);
+  }
+  if (idle && in0.size() > beat) {
+    std::fill(in0.begin() + beat, in0.end(), 0.0f);
+    std::fill(in1.begin() + beat, in1.end(), 0.0f);
+  }
+}
+
+// A chord on every beat, and each note lasts 80% of a beat. When `idle` is true, only the
+// first chord is played.
+std::vector<MidiEvent> makeMidiEvents(size_t length, double sampleRate, bool idle)
+{
+  constexpr std::array<int16_t, 4> root{48, 53, 55, 50};
+  constexpr std::array<int16_t, 3> chord{0, 4, 7};
+
+  const size_t beat = size_t(sampleRate * 0.5);
+  const size_t gate = size_t(0.8 * beat);
+
+  std::vector<MidiEvent> events;
+  int32_t noteId = 0;
+  const size_t end = idle ? std::min(beat, length) : length;
+  for (size_t frame = 0, count = 0; frame < end; frame += beat, ++count) {
+    for (const auto &interval : chord) {
+      const int16_t pitch = root[count % root.size()] + interval;
+      events.push_back({frame, true, noteId, pitch, 0.8f});
+      events.push_back({frame + gate, false, noteId, pitch, 0.0f});
+      ++noteId;
+    }
+  }
+  std::stable_sort(events.begin(), events.end(), [](const auto &a, const auto &b) {
+    return a.frame < b.frame;
+  });
+  return events;
+}
+
+Result runOne(
+  const Plugin &plugin,
+  const Variant &variant,
+  uint32_t presetIndex,
+  size_t blockSize,
+  const Options &opt,
+  const std::vector<float> &in0,
+  const std::vector<float> &in1,
+  const std::vector<MidiEvent> &events,
+  std::vector<float> *render = nullptr)
+{
+  auto target = variant.create();
+  target->parameter().loadProgram(presetIndex);
+  for (const auto &ovr : opt.overrides)
+    target->parameter().updateValue(ovr.first, ovr.second);
+  target->setup(opt.sampleRate);
+  target->prepare();
+
+  // Warm up blocks are processed but not timed. All blocks have the same length.
+  const size_t warmupBlocks
+    = (size_t(opt.warmup * opt.sampleRate) + blockSize - 1) / blockSize;
+  const size_t timedBlocks
+    = (size_t(opt.seconds * opt.sampleRate) + blockSize - 1) / blockSize;
+  const size_t nBlocks = std::min(warmupBlocks + timedBlocks, in0.size() / blockSize);
+
+  std::vector<float> out0(blockSize), out1(blockSize);
+  std::vector<double> elapsed; // In seconds.
+  elapsed.reserve(nBlocks);
+
+  auto event = events.begin();
+  for (size_t block = 0; block < nBlocks; ++block) {
+    const size_t start = block * blockSize;
+
+    // 4 second cycle of automation.
+    const double time = start / opt.sampleRate;
+    for (size_t idx = 0; opt.automation && idx < plugin.automation.size(); ++idx) {
+      const double offset = idx / double(plugin.automation.size());
+      const double phase = 2.0 * M_PI * (0.25 * time + offset);
+      target->parameter().updateValue(
+        plugin.automation[idx], float(0.5 + 0.4 * std::sin(phase)));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+
+    for (; event != events.end() && event->frame < start + blockSize; ++event) {
+      target->pushMidiNote(
+        event->isNoteOn, uint32_t(event->frame - start), event->noteId, event->pitch,
+        event->velocity);
+    }
+    target->process(
+      {120.0f, blockSize, in0.data() + start, in1.data() + start, out0.data(),
+       out1.data()});
+
+    auto end = std::chrono::steady_clock::now();
+    if (block >= warmupBlocks)
+      elapsed.push_back(std::chrono::duration<double>(end - begin).count());
+
+    // Warm up is included in render.
+    if (render == nullptr) continue;
+    for (size_t i = 0; i < blockSize; ++i) {
+      render->push_back(out0[i]);
+      render->push_back(out1[i]);
+    }
+  }
+
+  const double total = std::accumulate(elapsed.begin(), elapsed.end(), 0.0);
+  const size_t frames = elapsed.size() * blockSize;
+
+  std::sort(elapsed.begin(), elapsed.end());
+  const size_t p99Index = size_t(std::ceil(0.99 * elapsed.size())) - 1;
+
+  return {
+    plugin.presets[presetIndex],
+    variant.isa,
+    blockSize,
+    total * opt.sampleRate / frames,
+    1e9 * total / frames,
+    1e6 * elapsed[p99Index],
+  };
+}
+
+void printResult(const Plugin &plugin, const Result &result, const Options &opt)
+{
+  if (opt.json) {
+    nlohmann::json data;
+    data["plugin"] = plugin.name;
+    data["preset"] = result.preset;
+    data["isa"] = result.isa;
+    data["blockSize"] = result.blockSize;
+    data["sampleRate"] = opt.sampleRate;
+    data["seconds"] = opt.seconds;
+    data["rtf"] = result.rtf;
+    data["nsPerSample"] = result.nsPerSample;
+    data["p99BlockUs"] = result.p99BlockUs;
+    std::cout << data.dump() << std::endl;
+    return;
+  }
+
+  std::cout << std::left << std::setw(20) << plugin.name << std::setw(32) << result.preset
+            << std::setw(8) << result.isa << std::right << std::setw(6)
+            << result.blockSize << std::fixed << std::setprecision(4) << std::setw(10)
+            << result.rtf << std::setprecision(1) << std::setw(12) << result.nsPerSample
+            << std::setw(12) << result.p99BlockUs << std::endl;
+}
+
+void printDiff(
+  const Plugin &plugin,
+  const std::string &preset,
+  const std::string &isa,
+  const RenderDiff &diff,
+  const std::string &status,
+  const Options &opt)
+{
+  if (opt.json) {
+    nlohmann::json data;
+    data["plugin"] = plugin.name;
+    data["preset"] = preset;
+    data["isa"] = isa;
+    data["maxError"] = diff.maxError;
+    data["spectralDiff"] = diff.spectralDiff;
+    data["tolerance"] = plugin.tolerance;
+    data["status"] = status;
+    std::cout << data.dump() << std::endl;
+    return;
+  }
+
+  std::cout << std::left << std::setw(20) << plugin.name << std::setw(32) << preset
+            << std::setw(8) << isa << std::right << std::scientific
+            << std::setprecision(3) << std::setw(12) << diff.maxError << std::fixed
+            << std::setw(10) << diff.spectralDiff << "  " << status << std::endl;
+}
+
+// Renders with the first block size. Returns 1 if any comparison failed.
+int runGolden(
+  const Plugin &plugin,
+  const Options &opt,
+  const std::vector<uint32_t> &presetIndices,
+  const std::vector<float> &in0,
+  const std::vector<float> &in1,
+  const std::vector<MidiEvent> &events)
+{
+  const bool isRender = !opt.renderDir.empty();
+  const std::string &dir = isRender ? opt.renderDir : opt.compareDir;
+  const size_t blockSize = opt.blockSizes[0];
+
+  if (!isRender && !opt.json) {
+    std::cout << std::left << std::setw(20) << "plugin" << std::setw(32) << "preset"
+              << std::setw(8) << "isa" << std::right << std::setw(12) << "maxError"
+              << std::setw(10) << "dB" << "  status" << std::endl;
+  }
+
+  const int instrset = instrset_detect();
+  bool isFailed = false;
+  for (const auto &variant : plugin.variants) {
+    if (variant.instrset > instrset || !isSelected(opt.isas, variant.isa)) continue;
+
+    for (const auto &preset : presetIndices) {
+      const auto &name = plugin.presets[preset];
+      const std::string path = dir + "/" + plugin.name + "/" + variant.isa + "/"
+        + toFileName(name) + ".f32";
+
+      // Trimmed to make length independent of block size.
+      std::vector<float> data;
+      runOne(plugin, variant, preset, blockSize, opt, in0, in1, events, &data);
+      data.resize(2 * size_t((opt.warmup + opt.seconds) * opt.sampleRate));
+
+      if (isRender) {
+        if (writeRender(path, data)) continue;
+        std::cerr << "Error: Failed to write " << path << "\n";
+        return 1;
+      }
+
+      std::vector<float> reference;
+      RenderDiff diff;
+      std::string status = "ok";
+      if (!readRender(path, reference)) {
+        status = "missing";
+      } else if (reference.size() != data.size()) {
+        status = "length mismatch";
+      } else {
+        diff = compareRender(reference, data);
+        if (diff.maxError > plugin.tolerance) status = "FAIL";
+      }
+      if (status != "ok") isFailed = true;
+      printDiff(plugin, name, variant.isa, diff, status, opt);
+    }
+
+    // Variants are sorted in the order of plugin.cpp. Without --isa, only the first
+    // supported one is used, as it's what users hear.
+    if (opt.isas.empty()) break;
+  }
+  return isFailed ? 1 : 0;
+}
+
+int run(int argc, char **argv, const Plugin &plugin)
+{
+  Options opt;
+  if (!parseOptions(argc, argv, opt)) {
+    printHelp(argv[0]);
+    return 1;
+  }
+
+  // Most hosts flush denormals to zero on audio thread.
+  _mm_setcsr(_mm_getcsr() | 0x8040);
+
+  // Extra 2 blocks for rounding up warm up and timed part to multiple of block size.
+  const size_t maxBlockSize
+    = *std::max_element(opt.blockSizes.begin(), opt.blockSizes.end());
+  const size_t length
+    = size_t((opt.warmup + opt.seconds) * opt.sampleRate) + 2 * maxBlockSize;
+  std::vector<float> in0(length), in1(length);
+  fillInput(in0, in1, opt.sampleRate, opt.idle);
+  const auto events = makeMidiEvents(length, opt.sampleRate, opt.idle);
+
+  std::vector<uint32_t> presetIndices;
+  for (uint32_t idx = 0; idx < plugin.presets.size(); ++idx) {
+    if (isSelected(opt.presets, "all") || isSelected(opt.presets, plugin.presets[idx]))
+      presetIndices.push_back(idx);
+  }
+  if (presetIndices.empty()) {
+    std::cerr << "Error: No preset matched.\n";
+    return 1;
+  }
+
+  if (!opt.renderDir.empty() || !opt.compareDir.empty())
+    return runGolden(plugin, opt, presetIndices, in0, in1, events);
+
+  if (!opt.json) {
+    std::cout << std::left << std::setw(20) << "plugin" << std::setw(32) << "preset"
+              << std::setw(8) << "isa" << std::right << std::setw(6) << "block"
+              << std::setw(10) << "rtf" << std::setw(12) << "ns/sample" << std::setw(12)
+              << "p99 us" << std::endl;
+  }
+
+  const int instrset = instrset_detect();
+  for (const auto &variant : plugin.variants) {
+    if (variant.instrset > instrset || !isSelected(opt.isas, variant.isa)) continue;
+    for (const auto &preset : presetIndices) {
+      for (const auto &blockSize : opt.blockSizes) {
+        printResult(
+          plugin, runOne(plugin, variant, preset, blockSize, opt, in0, in1, events), opt);
+      }
+    }
+  }
+  return 0;
+}
+
+} // namespace Bench
@@ -0,0 +1,211 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "../../common/parameterinterface.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+Headless benchmark for DSPCore. Each plugin has a `<Plugin>.cpp` which wraps its DSPCore
+into `Bench::Target`, and passes it to `Bench::run`.
+
+Plugins can't be linked into a single binary because all of them define `DSPCore`,
+`GlobalParameter`, `Scales` and so on in global namespace. So there's one binary for
+each plugin, and `make run` collects the results.
+
+Scenario is fixed for reproducibility. Effects receive noise bursts and saw wave, and
+instruments receive chords on every beat at 120 BPM. Parameters listed in
+`Bench::Plugin::automation` are swept on every block. `--idle` stops input and notes
+after the first beat, to measure plugins which are idle on a send. `--static` stops the
+sweep, and `--set` changes parameters from preset, to measure modes which only run on
+static parameters.
+
+Reported values:
+
+- `rtf`: Real-time factor. Processing time divided by duration of rendered audio.
+- `nsPerSample`: Processing time per frame in nanoseconds.
+- `p99BlockUs`: 99th percentile of time to process a block in microseconds.
+
+The same scenario is used for golden render. `--render DIR` writes outputs, and
+`--compare DIR` checks outputs against them. See golden.hpp.
+*/
+namespace Bench {
+
+struct Block {
+  float tempo;
+  size_t length;
+  const float *in0;
+  const float *in1;
+  float *out0;
+  float *out1;
+};
+
+class Target {
+public:
+  virtual ~Target() {}
+
+  virtual ParameterInterface &parameter() = 0;
+
+  // Called after preset is loaded. Equivalent to `sampleRateChanged` and `activate`.
+  virtual void setup(double sampleRate) = 0;
+
+  // Wait for resources built off the audio thread, like wavetables.
+  virtual void prepare() {}
+
+  virtual void pushMidiNote(
+    bool isNoteOn, uint32_t frame, int32_t noteId, int16_t pitch, float velocity)
+  {
+  }
+
+  // Equivalent to `run` of plugin.cpp.
+  virtual void process(const Block &block) = 0;
+};
+
+// Holds DSPCore. Plugins with unusual `setParameters` or `process` derive this directly.
+template<typename DSP> class DSPTarget : public Target {
+public:
+  DSPTarget(std::unique_ptr<DSP> dsp) : dsp(std::move(dsp)) {}
+
+  ParameterInterface &parameter() override { return dsp->param; }
+
+  void setup(double sampleRate) override
+  {
+    dsp->setup(sampleRate);
+    dsp->startup();
+  }
+
+protected:
+  std::unique_ptr<DSP> dsp;
+};
+
+// Effect with `setParameters(tempo)` and `process(length, in0, in1, out0, out1)`.
+template<typename DSP> class EffectTarget : public DSPTarget<DSP> {
+public:
+  using DSPTarget<DSP>::DSPTarget;
+
+  void process(const Block &block) override
+  {
+    this->dsp->setParameters(block.tempo);
+    this->dsp->process(block.length, block.in0, block.in1, block.out0, block.out1);
+  }
+};
+
+// Instrument with `setParameters(tempo)` and `process(length, out0, out1)`.
+template<typename DSP> class InstrumentTarget : public DSPTarget<DSP> {
+public:
+  using DSPTarget<DSP>::DSPTarget;
+
+  void pushMidiNote(
+    bool isNoteOn, uint32_t frame, int32_t noteId, int16_t pitch, float velocity) override
+  {
+    this->dsp->pushMidiNote(isNoteOn, frame, noteId, pitch, 0.0f, velocity);
+  }
+
+  void process(const Block &block) override
+  {
+    this->dsp->setParameters(block.tempo);
+    this->dsp->process(block.length, block.out0, block.out1);
+  }
+};
+
+// Instrument which builds wavetable on a worker thread. `prepare` requests the table and
+// waits until it's built. Parameters aren't set and nothing is processed, so rendering
+// starts from the same state as a plugin which builds the table synchronously.
+template<typename DSP> class TableWorkerTarget : public InstrumentTarget<DSP> {
+public:
+  using InstrumentTarget<DSP>::InstrumentTarget;
+
+  void prepare() override
+  {
+    auto &dsp = this->dsp;
+    dsp->refreshTable();
+
+    // Gives up after 60 seconds.
+    for (int count = 0; count < 6000 && !dsp->isTableReady(); ++count)
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+};
+
+struct Variant {
+  std::string isa;
+  int instrset; // Minimum value of `instrset_detect()`.
+  std::function<std::unique_ptr<Target>()> create;
+};
+
+struct Plugin {
+  std::string name;
+  std::vector<std::string> presets; // `programName` of GlobalParameter.
+  std::vector<uint32_t> automation;  // Parameter IDs to sweep.
+  std::vector<Variant> variants;
+
+  double tolerance = 0; // Maximum absolute error allowed by `--compare`. 0 is bit exact.
+};
+
+template<typename Wrapper, typename Core>
+Variant makeVariant(std::string isa, int instrset)
+{
+  return {isa, instrset, []() {
+            return std::make_unique<Wrapper>(std::make_unique<Core>());
+          }};
+}
+
+// For plugins which have `DSPCORE_CLASS(INSTRSET)`. Order follows plugin.cpp.
+template<
+  template<typename> class Wrapper,
+  typename Interface,
+  typename AVX512,
+  typename AVX2,
+  typename SSE41,
+  typename SSE2>
+std::vector<Variant> simdVariants()
+{
+  return {
+    makeVariant<Wrapper<Interface>, AVX512>("AVX512", 10),
+    makeVariant<Wrapper<Interface>, AVX2>("AVX2", 8),
+    makeVariant<Wrapper<Interface>, SSE41>("SSE41", 5),
+    makeVariant<Wrapper<Interface>, SSE2>("SSE2", 2),
+  };
+}
+
+// For plugins which only have single `DSPCore` compiled with default flags.
+template<typename Wrapper, typename Core> std::vector<Variant> genericVariants()
+{
+  return {makeVariant<Wrapper, Core>("generic", 0)};
+}
+
+template<typename Parameter> std::vector<std::string> presetNames()
+{
+  Parameter param;
+  std::vector<std::string> names;
+  for (const auto &name : param.programName)
+    if (name != nullptr) names.push_back(name);
+  return names;
+}
+
+// Parses command line options, then runs all combinations of preset, block size and
+// instruction set. Run with `--help` to show options.
+int run(int argc, char **argv, const Plugin &plugin);
+
+} // namespace Bench
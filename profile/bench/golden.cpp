@@ -0,0 +1,134 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+/*
+This source is splitted because pocketfft_hdronly.h is slow to compile.
+*/
+
+#include "golden.hpp"
+
+#include "../../lib/ghc/fs_std.hpp"
+#include "../../lib/pocketfft/pocketfft_hdronly.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <complex>
+#include <fstream>
+
+namespace Bench {
+
+std::string toFileName(const std::string &name)
+{
+  std::string fileName(name);
+  for (auto &chr : fileName) {
+    if (!std::isalnum(static_cast<unsigned char>(chr)) && chr != '-' && chr != '+')
+      chr = '_';
+  }
+  return fileName;
+}
+
+bool writeRender(const std::string &path, const std::vector<float> &data)
+{
+  std::error_code ec;
+  fs::create_directories(fs::path(path).parent_path(), ec);
+  if (ec) return false;
+
+  std::ofstream file(path, std::ios::binary);
+  if (!file) return false;
+  const auto size = std::streamsize(sizeof(float) * data.size());
+  file.write(reinterpret_cast<const char *>(data.data()), size);
+  return bool(file);
+}
+
+bool readRender(const std::string &path, std::vector<float> &data)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return false;
+  const auto size = size_t(file.tellg());
+  data.resize(size / sizeof(float));
+  file.seekg(0);
+  file.read(reinterpret_cast<char *>(data.data()), std::streamsize(size));
+  return bool(file);
+}
+
+/**
+Power spectra of Hann windowed frames of one channel. Power is floored at -120 dB
+relative to full scale sine, so that differences in silence don't dominate the result.
+*/
+std::vector<std::vector<float>>
+powerSpectra(const std::vector<float> &data, size_t channel, size_t nChannel)
+{
+  constexpr size_t frameSize = 2048;
+  constexpr size_t hop = frameSize / 2;
+  constexpr size_t nBin = frameSize / 2 + 1;
+  const float floor = 1e-12f * float(frameSize * frameSize) / 16.0f;
+
+  std::vector<float> window(frameSize);
+  for (size_t i = 0; i < frameSize; ++i)
+    window[i] = 0.5f - 0.5f * std::cos(float(2.0 * M_PI) * i / frameSize);
+
+  const size_t length = data.size() / nChannel;
+  std::vector<float> frame(frameSize);
+  std::vector<std::complex<float>> spectrum(nBin);
+  std::vector<std::vector<float>> spectra;
+  for (size_t start = 0; start == 0 || start + frameSize <= length; start += hop) {
+    for (size_t i = 0; i < frameSize; ++i) {
+      const size_t index = start + i;
+      frame[i] = index < length ? window[i] * data[nChannel * index + channel] : 0.0f;
+    }
+    pocketfft::r2c<float>(
+      {frameSize}, {sizeof(float)}, {sizeof(std::complex<float>)}, {0}, true,
+      frame.data(), spectrum.data(), 1.0f);
+
+    auto &power = spectra.emplace_back(nBin);
+    for (size_t bin = 0; bin < nBin; ++bin)
+      power[bin] = std::max(std::norm(spectrum[bin]), floor);
+  }
+  return spectra;
+}
+
+RenderDiff
+compareRender(const std::vector<float> &reference, const std::vector<float> &data)
+{
+  RenderDiff diff;
+  for (size_t i = 0; i < reference.size(); ++i)
+    diff.maxError = std::max(diff.maxError, double(std::abs(data[i] - reference[i])));
+  if (diff.maxError == 0) return diff;
+
+  // Mean over frames of RMS over bins of dB difference.
+  constexpr size_t nChannel = 2;
+  double sum = 0;
+  size_t count = 0;
+  for (size_t ch = 0; ch < nChannel; ++ch) {
+    const auto specRef = powerSpectra(reference, ch, nChannel);
+    const auto specData = powerSpectra(data, ch, nChannel);
+    for (size_t frm = 0; frm < specRef.size(); ++frm) {
+      double sumSq = 0;
+      for (size_t bin = 0; bin < specRef[frm].size(); ++bin) {
+        const double dB = 10.0 * std::log10(specData[frm][bin] / specRef[frm][bin]);
+        sumSq += dB * dB;
+      }
+      sum += std::sqrt(sumSq / specRef[frm].size());
+      ++count;
+    }
+  }
+  diff.spectralDiff = sum / count;
+  return diff;
+}
+
+} // namespace Bench
@@ -0,0 +1,46 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+Golden render comparison. Renders are raw 32-bit float files of interleaved stereo
+samples. Reference renders are recorded from a known good build with `--render`, then
+later builds are checked against them with `--compare`.
+*/
+namespace Bench {
+
+struct RenderDiff {
+  double maxError = 0;     // Maximum absolute difference of samples.
+  double spectralDiff = 0; // Log spectral distance in dB. 0 means identical spectrum.
+};
+
+// Replaces characters which may not be allowed in file names.
+std::string toFileName(const std::string &name);
+
+// Creates parent directories. Returns false on failure.
+bool writeRender(const std::string &path, const std::vector<float> &data);
+bool readRender(const std::string &path, std::vector<float> &data);
+
+// Both must have the same length.
+RenderDiff
+compareRender(const std::vector<float> &reference, const std::vector<float> &data);
+
+} // namespace Bench
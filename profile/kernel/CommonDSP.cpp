@@ -0,0 +1,47 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../common/dsp/decimationLowpass.hpp"
+#include "kernel.hpp"
+
+using namespace SomeDSP;
+
+namespace {
+
+// Called once per oversampled sample in FoldShaper, ModuloShaper, OddPowShaper and
+// SoftClipper.
+KERNEL_FLATTEN KernelResult benchDecimationLowpass16(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  DecimationLowpass16<float> lowpass;
+  lowpass.reset();
+
+  KernelResult result{"DecimationLowpass16::push", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    lowpass.push(input[i]);
+    return lowpass.output();
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(CommonDSP)(size_t nSample)
+{
+  return {benchDecimationLowpass16(nSample)};
+}
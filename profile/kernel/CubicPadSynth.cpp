@@ -0,0 +1,263 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../CubicPadSynth/dsp/oscillator.hpp"
+#include "kernel.hpp"
+
+#include <cmath>
+#include <memory>
+#include <utility>
+
+using namespace SomeDSP;
+
+namespace {
+
+// Smaller than the plugin, but still larger than L2 cache.
+constexpr size_t tableSize = 1 << 14;
+constexpr size_t paddedSize = tableSize + 3;
+constexpr size_t blockStride = 16; // 4x4 floats.
+
+// Same layout as non-mipmapped `Wavetable`. All rows are on a contiguous memory.
+struct Table {
+  std::vector<float> buffer;
+  std::array<float *, nTablePadded> table;
+  std::array<int32_t, nTablePadded> offset;
+  std::array<float, nTablePadded> phaseScale;
+
+  Table() : buffer(nTablePadded * paddedSize)
+  {
+    std::minstd_rand rng(0);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (auto &value : buffer) value = dist(rng);
+
+    for (size_t idx = 0; idx < nTablePadded; ++idx) {
+      table[idx] = buffer.data() + idx * paddedSize;
+      offset[idx] = int32_t(idx * paddedSize);
+      phaseScale[idx] = 1.0f;
+    }
+  }
+};
+
+const Table &getTable()
+{
+  static const Table table;
+  return table;
+}
+
+// Interleaved layout. `block[row][x]` holds `table[row - 1 + dy][x - 1 + dx]` for dy and
+// dx in [0, 3], so a lane reads all 16 taps with one aligned 64 bytes load.
+struct BlockTable {
+  std::unique_ptr<float[]> buffer;
+  float *block; // 64 bytes aligned.
+
+  BlockTable(const Table &tbl)
+  {
+    const size_t blockSize = nTablePadded * paddedSize * blockStride;
+    buffer = std::make_unique<float[]>(blockSize + blockStride);
+    auto misalign = size_t(buffer.get()) / sizeof(float) % blockStride;
+    block = buffer.get() + (blockStride - misalign);
+    for (size_t row = 1; row < nTablePadded - 2; ++row) {
+      for (size_t x = 1; x < paddedSize - 2; ++x) {
+        float *dst = block + (row * paddedSize + x) * blockStride;
+        for (size_t dy = 0; dy < 4; ++dy)
+          for (size_t dx = 0; dx < 4; ++dx)
+            dst[4 * dy + dx] = tbl.table[row - 1 + dy][x - 1 + dx];
+      }
+    }
+  }
+};
+
+// 16 voices at random pitch.
+struct Voices {
+  Vec16f notePitch;
+  Vec16f frequency;
+
+  Voices()
+  {
+    std::minstd_rand rng(1);
+    std::uniform_real_distribution<float> dist(20.0f, 110.0f);
+    for (int i = 0; i < 16; ++i) {
+      const float pitch = dist(rng);
+      notePitch.insert(i, pitch);
+      frequency.insert(i, 440.0f * std::pow(2.0f, (pitch - 69.0f) / 12.0f));
+    }
+  }
+};
+
+// Phase and pitch handling of `TableOsc16`, for the layouts below.
+struct PhaseState {
+  Vec16f phase = 1;
+  Vec16f tick = 0;
+
+  void advance()
+  {
+    phase += tick;
+    phase = select(phase >= tableSize + 1, phase - tableSize, phase);
+  }
+
+  static Vec16f clampPitch(Vec16f notePitch)
+  {
+    notePitch = select(notePitch <= 0, 0, notePitch);
+    notePitch += float(1);
+    return select(notePitch >= notePitchUpperBound, notePitchUpperBound, notePitch);
+  }
+};
+
+// Reads taps like `TableOsc16` on SSE2 and SSE4.1, with scalar `extract()` and a row
+// pointer, but without per-row phase scaling. Compare to gather on AVX2 and AVX512.
+struct ExtractOsc16 : public PhaseState {
+  inline Vec16f loadTable(Vec16i ix, Vec16i iy, const Table &tbl)
+  {
+    const auto &table = tbl.table;
+    return Vec16f(
+      table[iy.extract(0)][ix.extract(0)], table[iy.extract(1)][ix.extract(1)],
+      table[iy.extract(2)][ix.extract(2)], table[iy.extract(3)][ix.extract(3)],
+      table[iy.extract(4)][ix.extract(4)], table[iy.extract(5)][ix.extract(5)],
+      table[iy.extract(6)][ix.extract(6)], table[iy.extract(7)][ix.extract(7)],
+      table[iy.extract(8)][ix.extract(8)], table[iy.extract(9)][ix.extract(9)],
+      table[iy.extract(10)][ix.extract(10)], table[iy.extract(11)][ix.extract(11)],
+      table[iy.extract(12)][ix.extract(12)], table[iy.extract(13)][ix.extract(13)],
+      table[iy.extract(14)][ix.extract(14)], table[iy.extract(15)][ix.extract(15)]);
+  }
+
+  inline Vec16f interpRow(Vec16i ix1, Vec16i iy, Vec16f xFrac, const Table &tbl)
+  {
+    return cubicInterp(
+      loadTable(ix1 - 1, iy, tbl), loadTable(ix1, iy, tbl), loadTable(ix1 + 1, iy, tbl),
+      loadTable(ix1 + 2, iy, tbl), xFrac);
+  }
+
+  Vec16f processCubic(Vec16f notePitch, const Table &tbl)
+  {
+    advance();
+    notePitch = clampPitch(notePitch);
+
+    Vec16f yFrac = notePitch - floor(notePitch);
+    Vec16i iy1 = truncatei(notePitch);
+    Vec16f xFrac = phase - floor(phase);
+    Vec16i ix1 = truncatei(phase);
+
+    Vec16f y0 = interpRow(ix1, iy1 - 1, xFrac, tbl);
+    Vec16f y1 = interpRow(ix1, iy1, xFrac, tbl);
+    Vec16f y2 = interpRow(ix1, iy1 + 1, xFrac, tbl);
+    Vec16f y3 = interpRow(ix1, iy1 + 2, xFrac, tbl);
+    return cubicInterp(y0, y1, y2, y3, yFrac);
+  }
+};
+
+// Swaps off-diagonal blocks of size `s`. Applying s = 8, 4, 2, 1 transposes 16x16.
+template<int s, int... j>
+inline void transposeStage(std::array<Vec16f, 16> &v, std::integer_sequence<int, j...>)
+{
+  for (int i = 0; i < 16; ++i) {
+    if (i & s) continue;
+    Vec16f a = v[i];
+    Vec16f b = v[i + s];
+    v[i] = blend16<((j & s) == 0 ? j : 16 + j - s)...>(a, b);
+    v[i + s] = blend16<((j & s) == 0 ? j + s : 16 + j)...>(a, b);
+  }
+}
+
+inline void transpose16x16(std::array<Vec16f, 16> &v)
+{
+  constexpr auto seq = std::make_integer_sequence<int, 16>{};
+  transposeStage<8>(v, seq);
+  transposeStage<4>(v, seq);
+  transposeStage<2>(v, seq);
+  transposeStage<1>(v, seq);
+}
+
+// Reads `BlockTable`. Loaded vectors are transposed to get a vector of 16 lanes for each
+// of 16 taps.
+struct BlockOsc16 : public PhaseState {
+  Vec16f processCubic(Vec16f notePitch, const BlockTable &tbl)
+  {
+    advance();
+    notePitch = clampPitch(notePitch);
+
+    Vec16f yFrac = notePitch - floor(notePitch);
+    Vec16i iy1 = truncatei(notePitch);
+    Vec16f xFrac = phase - floor(phase);
+    Vec16i ix1 = truncatei(phase);
+    Vec16i index = (iy1 * int32_t(paddedSize) + ix1) * int32_t(blockStride);
+
+    std::array<Vec16f, 16> v;
+    for (int i = 0; i < 16; ++i) v[i].load_a(tbl.block + index.extract(i));
+    transpose16x16(v);
+
+    Vec16f y0 = cubicInterp(v[0], v[1], v[2], v[3], xFrac);
+    Vec16f y1 = cubicInterp(v[4], v[5], v[6], v[7], xFrac);
+    Vec16f y2 = cubicInterp(v[8], v[9], v[10], v[11], xFrac);
+    Vec16f y3 = cubicInterp(v[12], v[13], v[14], v[15], xFrac);
+    return cubicInterp(y0, y1, y2, y3, yFrac);
+  }
+};
+
+// Results are per call, which outputs a sample for 16 voices. All 3 variants read the
+// same table at the same phase, so checksums match up to rounding.
+KERNEL_FLATTEN KernelResult benchTableOsc16(size_t nSample)
+{
+  const auto &table = getTable();
+  const Voices voices;
+
+  // 10 Hz is the default of tableBaseFrequency.
+  auto osc = std::make_unique<TableOsc16<tableSize>>();
+  osc->setFrequency(Kernel::sampleRate, voices.frequency, 10.0f);
+
+  KernelResult result{"TableOsc16::processCubic", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t) {
+    return horizontal_add(osc->processCubic(voices.notePitch, table));
+  });
+  return result;
+}
+
+KERNEL_FLATTEN KernelResult benchExtractOsc16(size_t nSample)
+{
+  const auto &table = getTable();
+  const Voices voices;
+
+  ExtractOsc16 osc;
+  osc.tick = voices.frequency / 10.0f;
+
+  KernelResult result{"TableOsc16 extract", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t) {
+    return horizontal_add(osc.processCubic(voices.notePitch, table));
+  });
+  return result;
+}
+
+KERNEL_FLATTEN KernelResult benchBlockOsc16(size_t nSample)
+{
+  static const BlockTable table(getTable());
+  const Voices voices;
+
+  BlockOsc16 osc;
+  osc.tick = voices.frequency / 10.0f;
+
+  KernelResult result{"TableOsc16 4x4 interleaved", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t) {
+    return horizontal_add(osc.processCubic(voices.notePitch, table));
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(CubicPadSynth)(size_t nSample)
+{
+  return {benchTableOsc16(nSample), benchExtractOsc16(nSample), benchBlockOsc16(nSample)};
+}
@@ -0,0 +1,59 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../EnvelopedSine/dsp/oscillator.hpp"
+#include "kernel.hpp"
+
+#include <memory>
+
+using namespace SomeDSP;
+
+namespace {
+
+// Size is the same as `oscillatorSize` in EnvelopedSine/dsp/dspcore.hpp.
+constexpr size_t oscillatorSize = 4;
+
+// Long envelope to keep the oscillator running through the measurement.
+KERNEL_FLATTEN KernelResult benchQuadOscExpAD(size_t nSample)
+{
+  std::minstd_rand rng(0);
+  std::uniform_real_distribution<float> dist(20.0f, 10000.0f);
+
+  auto osc = std::make_unique<QuadOscExpAD<oscillatorSize>>();
+  for (size_t i = 0; i < oscillatorSize; ++i) {
+    for (int j = 0; j < 16; ++j) osc->frequency[i].insert(j, dist(rng));
+    osc->attack[i] = 0.01f;
+    osc->decay[i] = 60.0f;
+    osc->saturation[i] = 2.0f;
+    osc->satMix[i] = 0.5f;
+    osc->gain[i] = 1.0f;
+    osc->phase[i] = 0.0f;
+  }
+  osc->setup(Kernel::sampleRate);
+
+  KernelResult result{"QuadOscExpAD<4>::process", 0, 0};
+  result.cyclesPerSample = Kernel::measure(
+    nSample, result.checksum, [&](size_t) { return osc->process(); });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(EnvelopedSine)(size_t nSample)
+{
+  return {benchQuadOscExpAD(nSample)};
+}
@@ -0,0 +1,61 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../common/dsp/somemath.hpp"
+#include "../../EsPhaser/dsp/phaser.hpp"
+#include "kernel.hpp"
+
+#include <memory>
+
+using namespace SomeDSP;
+
+namespace {
+
+// Same as EsPhaser/dsp/dspcore.cpp.
+#if INSTRSET >= 10
+using PhaserVec = Vec16f;
+#elif INSTRSET >= 8
+using PhaserVec = Vec8f;
+#else
+using PhaserVec = Vec4f;
+#endif
+
+// Both channels at 4096 stages, which is the maximum. LFO is slow, and fraction of
+// allpass moves in [0.25, 0.75].
+KERNEL_FLATTEN KernelResult benchStereoThiranPhaser(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto phaser = std::make_unique<StereoThiranPhaser>();
+  phaser->setup(48000.0f);
+  phaser->setStage(4095);
+
+  KernelResult result{"StereoThiranPhaser::process", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    const auto out = phaser->process<PhaserVec>(
+      {input[i], input[i]}, 0.0f, 0.0f, {0.0f, 1.0f}, 1e-4f, 0.5f, 0.25f, -0.5f);
+    return out[0] + out[1];
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(EsPhaser)(size_t nSample)
+{
+  return {benchStereoThiranPhaser(nSample)};
+}
@@ -0,0 +1,53 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../IterativeSinCluster/dsp/oscillator.hpp"
+#include "kernel.hpp"
+
+#include <memory>
+
+using namespace SomeDSP;
+
+namespace {
+
+// Size is the same as `nPitch` in IterativeSinCluster/dsp/dspcore.hpp.
+constexpr size_t nPitch = 8;
+
+KERNEL_FLATTEN KernelResult benchBiquadOsc(size_t nSample)
+{
+  std::minstd_rand rng(0);
+  std::uniform_real_distribution<float> dist(20.0f, 10000.0f);
+
+  auto osc = std::make_unique<BiquadOsc<nPitch>>();
+  for (size_t i = 0; i < nPitch; ++i) {
+    for (int j = 0; j < 16; ++j) osc->frequency[i].insert(j, dist(rng));
+    osc->gain[i] = 1.0f;
+  }
+  osc->setup(Kernel::sampleRate);
+
+  KernelResult result{"BiquadOsc<8>::process", 0, 0};
+  result.cyclesPerSample = Kernel::measure(
+    nSample, result.checksum, [&](size_t) { return osc->process(); });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(IterativeSinCluster)(size_t nSample)
+{
+  return {benchBiquadOsc(nSample)};
+}
@@ -0,0 +1,146 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "kernel.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+// 2x oversampled delay. L3Reverb used this and `LongAllpass` before FlatNestedAllpass.
+template<typename Sample> class Delay {
+public:
+  Sample w1 = 0;
+  Sample rFraction = 0.0;
+  int wptr = 0;
+  int rptr = 0;
+  int size = 0;
+  std::vector<Sample> buf;
+
+  void setup(Sample sampleRate, Sample maxTime)
+  {
+    size = int(Sample(2) * sampleRate * maxTime) + 1;
+    if (size < 4) size = 4;
+
+    buf.resize(size);
+
+    reset();
+  }
+
+  void reset()
+  {
+    w1 = 0;
+    std::fill(buf.begin(), buf.end(), 0);
+  }
+
+  Sample process(Sample input, Sample sampleRate, Sample seconds)
+  {
+    // Set delay time.
+    Sample timeInSample = std::clamp<Sample>(Sample(2) * sampleRate * seconds, 0, size);
+
+    auto timeInt = int(timeInSample);
+    rFraction = timeInSample - Sample(timeInt);
+
+    rptr = wptr - timeInt;
+    if (rptr < 0) rptr += size;
+
+    // Write to buffer.
+    buf[wptr] = Sample(0.5) * (input + w1);
+    ++wptr;
+    if (wptr >= size) wptr -= size;
+
+    buf[wptr] = input;
+    ++wptr;
+    if (wptr >= size) wptr -= size;
+
+    w1 = input;
+
+    // Read from buffer.
+    const unsigned int i1 = rptr;
+    ++rptr;
+    if (rptr >= size) rptr -= size;
+
+    const unsigned int i0 = rptr;
+    ++rptr;
+    if (rptr >= size) rptr -= size;
+
+    return buf[i0] - rFraction * (buf[i0] - buf[i1]);
+  }
+};
+
+/**
+Allpass filter with arbitrary length delay.
+https://ccrma.stanford.edu/~jos/pasp/Allpass_Two_Combs.html
+*/
+template<typename Sample> class LongAllpass {
+public:
+  Sample buffer = 0;
+  Delay<Sample> delay;
+
+  void setup(Sample sampleRate, Sample maxTime) { delay.setup(sampleRate, maxTime); }
+
+  void reset()
+  {
+    buffer = 0;
+    delay.reset();
+  }
+
+  // gain in [0, 1].
+  Sample process(Sample input, Sample sampleRate, Sample seconds, Sample gain)
+  {
+    input -= gain * buffer;
+    auto output = buffer + gain * input;
+    buffer = delay.process(input, sampleRate, seconds);
+    return output;
+  }
+};
+
+KERNEL_FLATTEN KernelResult benchDelay(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto delay = std::make_unique<Delay<float>>();
+  delay->setup(Kernel::sampleRate, 0.1f);
+
+  KernelResult result{"Delay::process (L3Reverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    return delay->process(input[i], Kernel::sampleRate, 0.0437f);
+  });
+  return result;
+}
+
+KERNEL_FLATTEN KernelResult benchLongAllpass(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto allpass = std::make_unique<LongAllpass<float>>();
+  allpass->setup(Kernel::sampleRate, 0.1f);
+
+  KernelResult result{"LongAllpass::process (L3Reverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    return allpass->process(input[i], Kernel::sampleRate, 0.0437f, 0.5f);
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(L3Reverb)(size_t nSample)
+{
+  return {benchDelay(nSample), benchLongAllpass(nSample)};
+}
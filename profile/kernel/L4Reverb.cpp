@@ -1,33 +1,32 @@
 // (c) 2020 Takamitsu Endo
 //
-// This file is part of L4Reverb.
+// This file is part of Uhhyou Plugins.
 //
-// L4Reverb is free software: you can redistribute it and/or modify
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
 // it under the terms of the GNU General Public License as published by
 // the Free Software Foundation, either version 3 of the License, or
 // (at your option) any later version.
 //
-// L4Reverb is distributed in the hope that it will be useful,
+// Uhhyou Plugins is distributed in the hope that it will be useful,
 // but WITHOUT ANY WARRANTY; without even the implied warranty of
 // MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
 // GNU General Public License for more details.
 //
 // You should have received a copy of the GNU General Public License
-// along with L4Reverb.  If not, see <https://www.gnu.org/licenses/>.
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
 
-#pragma once
-
-#include "../../common/dsp/constants.hpp"
-#include "../../common/dsp/smoother.hpp"
+#include "../../common/dsp/nestedallpass.hpp"
+#include "kernel.hpp"
 
 #include <algorithm>
-#include <array>
-#include <climits>
-#include <vector>
+#include <memory>
+
+using namespace SomeDSP;
 
-namespace SomeDSP {
+namespace {
 
-// 2x oversampled delay.
+// 2x oversampled delay. Classes from here to `NestD4` are the recursive nested allpass
+// which L4Reverb used before FlatNestedAllpass. `benchNestD4` compares them with it.
 template<typename Sample> class Delay {
 public:
   Sample w1 = 0;
@@ -117,10 +116,6 @@ public:
 
 template<typename Sample, uint8_t nest> class NestedLongAllpass {
 public:
-  std::array<ExpSmoother<Sample>, nest> seconds{};
-  std::array<ExpSmoother<Sample>, nest> innerFeed{};
-  std::array<ExpSmoother<Sample>, nest> outerFeed{};
-
   std::array<Sample, nest> in{};
   std::array<Sample, nest> buffer{};
   std::array<LongAllpass<Sample>, nest> allpass;
@@ -137,18 +132,23 @@ public:
     for (auto &ap : allpass) ap.reset();
   }
 
-  Sample process(Sample input, Sample sampleRate)
+  Sample
+  process(Sample input, Sample sampleRate, const NestParameter<Sample> &prm, size_t index)
   {
+    const size_t offset = index * nest;
+    const Sample *seconds = prm.seconds + offset;
+    const Sample *innerFeed = prm.innerFeed + offset;
+    const Sample *outerFeed = prm.feed[0] + offset;
+
     for (uint8_t idx = 0; idx < nest; ++idx) {
-      input -= outerFeed[idx].process() * buffer[idx];
+      input -= outerFeed[idx] * buffer[idx];
       in[idx] = input;
     }
 
     Sample out = in.back();
     for (uint8_t idx = nest - 1; idx < nest; --idx) {
-      auto apOut = allpass[idx].process(
-        out, sampleRate, seconds[idx].process(), innerFeed[idx].process());
-      out = buffer[idx] + outerFeed[idx].getValue() * in[idx];
+      auto apOut = allpass[idx].process(out, sampleRate, seconds[idx], innerFeed[idx]);
+      out = buffer[idx] + outerFeed[idx] * in[idx];
       buffer[idx] = apOut;
     }
 
@@ -156,12 +156,11 @@ public:
   }
 };
 
-#define NESTED_ALLPASS(NAME, CHILD)                                                      \
+#define NESTED_ALLPASS(NAME, CHILD, DEPTH)                                               \
   template<typename Sample, uint8_t nest> class NAME {                                   \
   public:                                                                                \
     std::array<Sample, nest> in{};                                                       \
     std::array<Sample, nest> buffer{};                                                   \
-    std::array<ExpSmoother<Sample>, nest> feed;                                          \
     std::array<CHILD<Sample, nest>, nest> allpass;                                       \
                                                                                          \
     void setup(Sample sampleRate, Sample maxTime)                                        \
@@ -176,17 +175,21 @@ public:
       for (auto &ap : allpass) ap.reset();                                               \
     }                                                                                    \
                                                                                          \
-    Sample process(Sample input, Sample sampleRate)                                      \
+    Sample process(                                                                      \
+      Sample input, Sample sampleRate, const NestParameter<Sample> &prm, size_t index)   \
     {                                                                                    \
+      const size_t offset = index * nest;                                                \
+      const Sample *feed = prm.feed[DEPTH - 1] + offset;                                 \
+                                                                                         \
       for (uint8_t idx = 0; idx < nest; ++idx) {                                         \
-        input -= feed[idx].process() * buffer[idx];                                      \
+        input -= feed[idx] * buffer[idx];                                                \
         in[idx] = input;                                                                 \
       }                                                                                  \
                                                                                          \
       Sample out = in.back();                                                            \
       for (uint8_t idx = nest - 1; idx < nest; --idx) {                                  \
-        auto apOut = allpass[idx].process(out, sampleRate);                              \
-        out = buffer[idx] + feed[idx].getValue() * in[idx];                              \
+        auto apOut = allpass[idx].process(out, sampleRate, prm, offset + idx);           \
+        out = buffer[idx] + feed[idx] * in[idx];                                         \
         buffer[idx] = apOut;                                                             \
       }                                                                                  \
                                                                                          \
@@ -194,8 +197,97 @@ public:
     }                                                                                    \
   };
 
-NESTED_ALLPASS(NestD2, NestedLongAllpass)
-NESTED_ALLPASS(NestD3, NestD2)
-NESTED_ALLPASS(NestD4, NestD3)
+NESTED_ALLPASS(NestD2, NestedLongAllpass, 2)
+NESTED_ALLPASS(NestD3, NestD2, 3)
+NESTED_ALLPASS(NestD4, NestD3, 4)
+
+KERNEL_FLATTEN KernelResult benchDelay(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto delay = std::make_unique<Delay<float>>();
+  delay->setup(Kernel::sampleRate, 0.1f);
+
+  KernelResult result{"Delay::process (L4Reverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    return delay->process(input[i], Kernel::sampleRate, 0.0437f);
+  });
+  return result;
+}
+
+// Parameters of all allpasses in the order of `NestParameter`.
+struct NestInput {
+  static constexpr size_t nAllpass = 256;
+
+  std::vector<float> seconds;
+  std::vector<float> innerFeed;
+  std::array<std::vector<float>, 4> feed;
 
-} // namespace SomeDSP
+  NestInput() : seconds(nAllpass, 0.0f), innerFeed(nAllpass, 0.0f)
+  {
+    std::minstd_rand rng(0);
+    std::uniform_real_distribution<float> timeDist(0.001f, 0.1f);
+    std::uniform_real_distribution<float> feedDist(0.0f, 0.9f);
+    for (auto &value : seconds) value = timeDist(rng);
+    for (auto &value : innerFeed) value = feedDist(rng);
+    for (size_t depth = 0; depth < feed.size(); ++depth) {
+      feed[depth].resize(nAllpass >> (2 * depth));
+      for (auto &value : feed[depth]) value = feedDist(rng);
+    }
+  }
+
+  NestParameter<float> get() const
+  {
+    return {
+      seconds.data(),
+      innerFeed.data(),
+      {feed[0].data(), feed[1].data(), feed[2].data(), feed[3].data()}};
+  }
+};
+
+KERNEL_FLATTEN KernelResult benchNestD4(size_t nSample, float sampleRate)
+{
+  static const Kernel::Input input;
+  static const NestInput nestInput;
+  const auto prm = nestInput.get();
+
+  auto delay = std::make_unique<NestD4<float, 4>>();
+  delay->setup(sampleRate, 1.0f); // Same as maximum of Scales::time.
+
+  const auto rate = std::to_string(int(sampleRate / 1000)) + "kHz";
+  KernelResult result{"NestD4 " + rate + " (L4Reverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    return delay->process(input[i], sampleRate, prm, 0);
+  });
+  return result;
+}
+
+KERNEL_FLATTEN KernelResult benchFlatNestedAllpass(size_t nSample, float sampleRate)
+{
+  static const Kernel::Input input;
+  static const NestInput nestInput;
+  const auto prm = nestInput.get();
+
+  auto delay = std::make_unique<FlatNestedAllpass<float, 4, 4, 4, 4>>();
+  delay->setup(sampleRate, 1.0f); // Same as maximum of Scales::time.
+
+  const auto rate = std::to_string(int(sampleRate / 1000)) + "kHz";
+  KernelResult result{"FlatNestedAllpass " + rate + " (L4Reverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    return delay->process(input[i], sampleRate, prm);
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(L4Reverb)(size_t nSample)
+{
+  return {
+    benchDelay(nSample),
+    benchNestD4(nSample, 48000.0f),
+    benchFlatNestedAllpass(nSample, 48000.0f),
+    benchNestD4(nSample, 192000.0f),
+    benchFlatNestedAllpass(nSample, 192000.0f),
+  };
+}
@@ -0,0 +1,48 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../LatticeReverb/dsp/delay.hpp"
+#include "kernel.hpp"
+
+#include <memory>
+
+using namespace SomeDSP;
+
+namespace {
+
+KERNEL_FLATTEN KernelResult benchDelay(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto delay = std::make_unique<OversampledDelay<float, AverageMidpoint>>();
+  delay->setup(Kernel::sampleRate, 0, 0.1f);
+
+  // LongAllpass sets delay time on every sample.
+  KernelResult result{"OversampledDelay::process (LatticeReverb)", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    delay->setTime(0.0437f);
+    return delay->process(input[i]);
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(LatticeReverb)(size_t nSample)
+{
+  return {benchDelay(nSample)};
+}
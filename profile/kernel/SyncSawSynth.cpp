@@ -0,0 +1,49 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+// oscillator.hpp relies on <cstdint> and constants.hpp included before it.
+#include "kernel.hpp"
+
+#include "../../common/dsp/constants.hpp"
+#include "../../SyncSawSynth/dsp/oscillator.hpp"
+
+using namespace SomeDSP;
+
+namespace {
+
+// Sync frequency is lower than oscillator, so both hard sync and normal wrap happen.
+KERNEL_FLATTEN KernelResult benchPTRSyncSaw(size_t nSample, uint32_t order)
+{
+  PTRSyncSaw<float> saw(Kernel::sampleRate, 1234.5f, 345.6f);
+  saw.setOrder(order);
+
+  KernelResult result{"PTRSyncSaw::process order " + std::to_string(order), 0, 0};
+  result.cyclesPerSample = Kernel::measure(
+    nSample, result.checksum, [&](size_t) { return saw.process(); });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(SyncSawSynth)(size_t nSample)
+{
+  // Same as the range of `Scales::ptrOrder` in SyncSawSynth/parameter.cpp.
+  std::vector<KernelResult> results;
+  for (uint32_t order = 0; order <= 16; ++order)
+    results.push_back(benchPTRSyncSaw(nSample, order));
+  return results;
+}
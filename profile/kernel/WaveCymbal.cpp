@@ -0,0 +1,71 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "../../common/dsp/somemath.hpp"
+#include "../../lib/vcl/vectorclass.h"
+#include "../../WaveCymbal/dsp/wave.hpp"
+#include "kernel.hpp"
+
+#include <memory>
+
+using namespace SomeDSP;
+
+namespace {
+
+// Size is the same as `WaveHat::maxStack` in WaveCymbal/dsp/ksstring.hpp.
+constexpr size_t maxStack = 64;
+
+// A pulse on every 4096 samples, like a string repeatedly hit by collision.
+KERNEL_FLATTEN KernelResult benchWave1D(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto wave = std::make_unique<Wave1D<float, maxStack>>();
+  wave->setup(Kernel::sampleRate, maxStack, 0.5f, 0.5f, 0.1f);
+
+  KernelResult result{"Wave1D<64>::step", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    if (i % Kernel::Input::size == 0) wave->pulse(input[i]);
+    wave->step();
+    return (*wave)[maxStack / 2];
+  });
+  return result;
+}
+
+// Same as above, with waves of 4 cymbals in Vec4f like WaveHat.
+KERNEL_FLATTEN KernelResult benchWave1DBatch(size_t nSample)
+{
+  static const Kernel::Input input;
+
+  auto wave = std::make_unique<Wave1D<float, maxStack, Vec4f>>();
+  wave->setup(Kernel::sampleRate, maxStack, 0.5f, 0.5f, 0.1f);
+
+  KernelResult result{"Wave1D<64, Vec4f>::step", 0, 0};
+  result.cyclesPerSample = Kernel::measure(nSample, result.checksum, [&](size_t i) {
+    if (i % Kernel::Input::size == 0) wave->pulse(input[i]);
+    wave->step();
+    return (*wave)[maxStack / 2][0];
+  });
+  return result;
+}
+
+} // namespace
+
+std::vector<KernelResult> KERNEL_SUITE(WaveCymbal)(size_t nSample)
+{
+  return {benchWave1D(nSample), benchWave1DBatch(nSample)};
+}
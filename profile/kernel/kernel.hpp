@@ -0,0 +1,125 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "../../lib/vcl/vectorclass.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <x86intrin.h>
+
+/**
+Micro-benchmark of DSP primitives. Complements `profile/bench` which measures whole
+DSPCore.
+
+Each `<Suite>.cpp` includes DSP headers of a plugin, and is compiled once for each
+instruction set like `dsp/dspcore.cpp` of plugins. `KERNEL_SUITE(Suite)` appends ISA to
+the function name, so main.cpp can call all of them.
+
+Measured functions are marked with `KERNEL_FLATTEN`. It inlines the kernel into the code
+compiled for the ISA. Otherwise the linker may pick an inline function compiled for
+another ISA, or `Delay` of another plugin which has the same name.
+
+Result is in TSC ticks per sample. TSC runs at nominal clock of CPU, so it differs from
+core cycles when turbo boost is active.
+*/
+
+struct KernelResult {
+  std::string name;
+  double cyclesPerSample;
+  double checksum; // Sum of outputs. Keeps compiler from removing the kernel.
+};
+
+using KernelSuite = std::vector<KernelResult> (*)(size_t nSample);
+
+#if INSTRSET >= 10
+#define KERNEL_SUITE(suite) suite##_AVX512
+#elif INSTRSET >= 8
+#define KERNEL_SUITE(suite) suite##_AVX2
+#elif INSTRSET >= 5
+#define KERNEL_SUITE(suite) suite##_SSE41
+#else
+#define KERNEL_SUITE(suite) suite##_SSE2
+#endif
+
+#define KERNEL_FLATTEN __attribute__((flatten, noinline))
+
+#define DECLARE_KERNEL_SUITE(suite)                                                      \
+  std::vector<KernelResult> suite##_AVX512(size_t nSample);                              \
+  std::vector<KernelResult> suite##_AVX2(size_t nSample);                                \
+  std::vector<KernelResult> suite##_SSE41(size_t nSample);                               \
+  std::vector<KernelResult> suite##_SSE2(size_t nSample);
+
+DECLARE_KERNEL_SUITE(CommonDSP)
+DECLARE_KERNEL_SUITE(CubicPadSynth)
+DECLARE_KERNEL_SUITE(EnvelopedSine)
+DECLARE_KERNEL_SUITE(EsPhaser)
+DECLARE_KERNEL_SUITE(IterativeSinCluster)
+DECLARE_KERNEL_SUITE(L3Reverb)
+DECLARE_KERNEL_SUITE(L4Reverb)
+DECLARE_KERNEL_SUITE(LatticeReverb)
+DECLARE_KERNEL_SUITE(SyncSawSynth)
+DECLARE_KERNEL_SUITE(WaveCymbal)
+
+namespace Kernel {
+
+constexpr float sampleRate = 48000.0f;
+constexpr size_t nTrial = 5;
+
+// White noise in [-0.5, 0.5]. Small enough to stay in L1 cache.
+struct Input {
+  static constexpr size_t size = 4096;
+  std::array<float, size> data;
+
+  Input()
+  {
+    std::minstd_rand rng(0);
+    std::uniform_real_distribution<float> dist(-0.5f, 0.5f);
+    for (auto &value : data) value = dist(rng);
+  }
+
+  inline float operator[](size_t index) const { return data[index % size]; }
+};
+
+/**
+Calls `func(index)` for `nSample` times, and returns the minimum of TSC ticks per call
+over `nTrial` runs. `func` returns an output sample. Outputs are stored instead of summed
+in the loop, so that latency of addition doesn't hide the cost of fast kernels.
+*/
+template<typename Func> inline double measure(size_t nSample, double &checksum, Func func)
+{
+  std::array<float, Input::size> out{};
+  double best = std::numeric_limits<double>::max();
+  for (size_t trial = 0; trial < nTrial; ++trial) {
+    const uint64_t start = __rdtsc();
+    for (size_t i = 0; i < nSample; ++i) out[i % Input::size] = func(i);
+    const uint64_t end = __rdtsc();
+    best = std::min(best, double(end - start) / nSample);
+    for (const auto &value : out) checksum += value;
+  }
+  return best;
+}
+
+} // namespace Kernel
@@ -0,0 +1,118 @@
+// (c) 2020 Takamitsu Endo
+//
+// This file is part of Uhhyou Plugins.
+//
+// Uhhyou Plugins is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// Uhhyou Plugins is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Uhhyou Plugins.  If not, see <https://www.gnu.org/licenses/>.
+
+#include "kernel.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+struct Isa {
+  const char *name;
+  int instrset; // Minimum value of `instrset_detect()`.
+  std::vector<KernelSuite> suites;
+};
+
+#define KERNEL_SUITES(ISA)                                                               \
+  {                                                                                      \
+    CommonDSP_##ISA, CubicPadSynth_##ISA, EnvelopedSine_##ISA, EsPhaser_##ISA,           \
+      IterativeSinCluster_##ISA, L3Reverb_##ISA, L4Reverb_##ISA, LatticeReverb_##ISA,    \
+      SyncSawSynth_##ISA, WaveCymbal_##ISA,                                              \
+  }
+
+void printHelp(const char *command)
+{
+  std::cout << "Usage: " << command << " [options]\n"
+            << "  --samples N      Number of samples per trial. Default is 1048576.\n"
+            << "  --isa NAME,...   AVX512, AVX2, SSE41 or SSE2. Default is all\n"
+            << "                   supported by this CPU.\n"
+            << "  --filter TEXT    Only print kernels whose name contains TEXT.\n";
+}
+
+std::vector<std::string> splitComma(const std::string &text)
+{
+  std::vector<std::string> list;
+  std::stringstream stream(text);
+  std::string item;
+  while (std::getline(stream, item, ','))
+    if (!item.empty()) list.push_back(item);
+  return list;
+}
+
+int main(int argc, char **argv)
+{
+  size_t nSample = 1 << 20;
+  std::vector<std::string> isaNames;
+  std::string filter;
+  for (int idx = 1; idx < argc; ++idx) {
+    const std::string key(argv[idx]);
+    if (key == "--help" || idx + 1 >= argc) {
+      printHelp(argv[0]);
+      return 1;
+    }
+
+    const std::string value(argv[++idx]);
+    if (key == "--samples") {
+      nSample = std::stoul(value);
+    } else if (key == "--isa") {
+      isaNames = splitComma(value);
+    } else if (key == "--filter") {
+      filter = value;
+    } else {
+      printHelp(argv[0]);
+      return 1;
+    }
+  }
+  if (nSample == 0) {
+    printHelp(argv[0]);
+    return 1;
+  }
+
+  // Denormals are flushed on audio thread of most hosts.
+  _mm_setcsr(_mm_getcsr() | 0x8040);
+
+  const std::vector<Isa> isas{
+    {"AVX512", 10, KERNEL_SUITES(AVX512)},
+    {"AVX2", 8, KERNEL_SUITES(AVX2)},
+    {"SSE41", 5, KERNEL_SUITES(SSE41)},
+    {"SSE2", 2, KERNEL_SUITES(SSE2)},
+  };
+
+  const int instrset = instrset_detect();
+  std::printf("instrset: %d\n", instrset);
+  std::printf("TSC ticks per sample.\n");
+  std::printf("%-8s %-36s %12s %14s\n", "ISA", "kernel", "cycles", "checksum");
+
+  for (const auto &isa : isas) {
+    if (isa.instrset > instrset) continue;
+    if (
+      !isaNames.empty()
+      && std::find(isaNames.begin(), isaNames.end(), isa.name) == isaNames.end())
+      continue;
+
+    for (const auto &suite : isa.suites) {
+      for (const auto &result : suite(nSample)) {
+        if (result.name.find(filter) == std::string::npos) continue;
+        std::printf(
+          "%-8s %-36s %12.2f %14.6g\n", isa.name, result.name.c_str(),
+          result.cyclesPerSample, result.checksum);
+      }
+    }
+  }
+  return 0;
+}